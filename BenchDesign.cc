@@ -0,0 +1,157 @@
+// Resizer, LEF/DEF gate resizer
+// Copyright (c) 2019, Parallax Software, Inc.
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+#include <cmath>
+#include <random>
+#include "Machine.hh"
+#include "Report.hh"
+#include "StringUtil.hh"
+#include "PortDirection.hh"
+#include "Liberty.hh"
+#include "LefDefNetwork.hh"
+#include "BenchDesign.hh"
+
+namespace sta {
+
+using std::ceil;
+using std::max;
+using std::min;
+using std::sqrt;
+using std::string;
+
+void
+makeBenchDesign(LibertyCell *cell,
+		int inst_count,
+		int max_fanout,
+		double spread,
+		int seed,
+		LefDefNetwork *network)
+{
+  Report *report = network->report();
+  Library *lef_library = network->lefLibrary();
+  if (lef_library == nullptr) {
+    report->printError("Error; no LEF library has been read.\n");
+    return;
+  }
+  Cell *lef_cell = network->lefCell(cell);
+  if (lef_cell == nullptr) {
+    report->printError("Error: LEF macro %s not found.\n", cell->name());
+    return;
+  }
+  LibertyPort *input, *output;
+  cell->bufferPorts(input, output);
+  Port *cell_in = network->findPort(lef_cell, input->name());
+  Port *cell_out = network->findPort(lef_cell, output->name());
+  if (cell_in == nullptr
+      || cell_out == nullptr) {
+    report->printError("Error: LEF macro %s pins do not match liberty.\n",
+		       cell->name());
+    return;
+  }
+  if (inst_count < 1)
+    inst_count = 1;
+  if (max_fanout < 1)
+    max_fanout = 1;
+
+  // Random tree topology: instance d drives sinks
+  // [sink_begin[d], sink_end[d]), assigned in order, so every
+  // instance but the root has exactly one driver.
+  std::mt19937 gen(seed);
+  std::uniform_int_distribution<int> fanout_dist(1, max_fanout);
+  Vector<int> sink_begin(inst_count);
+  Vector<int> sink_end(inst_count);
+  int next_sink = 1;
+  for (int d = 0; d < inst_count; d++) {
+    sink_begin[d] = next_sink;
+    if (next_sink < inst_count)
+      next_sink = min(next_sink + fanout_dist(gen), inst_count);
+    sink_end[d] = next_sink;
+  }
+
+  network->setDefUnits(1000);
+  // Grid pitch from the cell size scaled by spread (microns).
+  const LefMacroSize *size = network->lefMacroSize(lef_cell);
+  double pitch = 1.0;
+  if (size)
+    pitch = max(size->sizeX(), size->sizeY());
+  pitch *= 2.0 * spread;
+  DefDbu pitch_dbu = static_cast<DefDbu>(pitch * 1000);
+  if (pitch_dbu < 1)
+    pitch_dbu = 1;
+  int grid_side = static_cast<int>(ceil(sqrt(static_cast<double>(inst_count))));
+
+  // Mirror the DEF reader construction sequence: top cell, ports,
+  // components, nets.
+  Cell *top_cell = network->makeCell(lef_library, "bench", false, nullptr);
+  Instance *top_inst = network->makeInstance(top_cell, "", nullptr);
+  network->setTopInstance(top_inst);
+  network->setDieArea(0, 0,
+		      (grid_side + 1) * pitch_dbu,
+		      (grid_side + 1) * pitch_dbu);
+
+  Port *in_port = network->makePort(top_cell, "in1");
+  network->setDirection(in_port, PortDirection::input());
+  Vector<Port*> out_ports(inst_count);
+  int leaf_count = 0;
+  for (int d = 0; d < inst_count; d++) {
+    if (sink_begin[d] == sink_end[d]) {
+      leaf_count++;
+      string port_name;
+      stringPrint(port_name, "out%d", d);
+      Port *out_port = network->makePort(top_cell, port_name.c_str());
+      network->setDirection(out_port, PortDirection::output());
+      out_ports[d] = out_port;
+    }
+    else
+      out_ports[d] = nullptr;
+  }
+  network->initTopInstancePins();
+  network->groupBusPorts(top_cell);
+
+  Vector<Instance*> insts(inst_count);
+  for (int i = 0; i < inst_count; i++) {
+    string inst_name;
+    stringPrint(inst_name, "b%d", i);
+    Instance *inst = network->makeDefComponent(lef_cell, inst_name.c_str(),
+					       nullptr, false);
+    network->setLocation(inst, DefPt((i % grid_side + 1) * pitch_dbu,
+				     (i / grid_side + 1) * pitch_dbu));
+    insts[i] = inst;
+  }
+
+  Net *in_net = network->makeNet("in1", top_inst);
+  Pin *in_pin = network->makePin(top_inst, in_port, nullptr);
+  network->makeTerm(in_pin, in_net);
+  network->connect(insts[0], cell_in, in_net);
+  for (int d = 0; d < inst_count; d++) {
+    string net_name;
+    stringPrint(net_name, "n%d", d);
+    Net *net = network->makeNet(net_name.c_str(), top_inst);
+    network->connect(insts[d], cell_out, net);
+    if (out_ports[d]) {
+      Pin *out_pin = network->makePin(top_inst, out_ports[d], nullptr);
+      network->makeTerm(out_pin, net);
+    }
+    else {
+      for (int s = sink_begin[d]; s < sink_end[d]; s++)
+	network->connect(insts[s], cell_in, net);
+    }
+  }
+  report->print("Made bench design with %d instances, %d ports.\n",
+		inst_count, leaf_count + 1);
+}
+
+} // namespace
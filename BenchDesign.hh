@@ -0,0 +1,42 @@
+// Resizer, LEF/DEF gate resizer
+// Copyright (c) 2019, Parallax Software, Inc.
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+#ifndef RESIZER_BENCH_DESIGN_H
+#define RESIZER_BENCH_DESIGN_H
+
+namespace sta {
+
+class LefDefNetwork;
+class LibertyCell;
+
+// Synthesize a placed design directly into the network for
+// benchmarking the resizer kernels (test/bench.tcl, resizer_bench
+// build target). The design is a random tree of inst_count instances
+// of cell (a buffer) rooted at top level port in1, with per-net
+// fanout drawn uniformly from [1, max_fanout] using seed and leaf
+// drivers connected to output ports. Instances are placed on a grid
+// whose pitch is the cell size scaled by spread. The LEF library and
+// liberty for cell must be read first.
+void
+makeBenchDesign(LibertyCell *cell,
+		int inst_count,
+		int max_fanout,
+		double spread,
+		int seed,
+		LefDefNetwork *network);
+
+} // namespace
+#endif
@@ -1,19 +1,22 @@
 // Resizer, LEF/DEF gate resizer
 // Copyright (c) 2019, Parallax Software, Inc.
-// 
+//
 // This program is free software: you can redistribute it and/or modify
 // it under the terms of the GNU General Public License as published by
 // the Free Software Foundation, either version 3 of the License, or
 // (at your option) any later version.
-// 
+//
 // This program is distributed in the hope that it will be useful,
 // but WITHOUT ANY WARRANTY; without even the implied warranty of
 // MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
 // GNU General Public License for more details.
-// 
+//
 // You should have received a copy of the GNU General Public License
 // along with this program.  If not, see <https://www.gnu.org/licenses/>.
 
+#include <atomic>
+#include <thread>
+#include <utility>
 #include "Machine.hh"
 #include "Report.hh"
 #include "Error.hh"
@@ -26,6 +29,12 @@
 
 namespace sta {
 
+using std::string;
+
+// Records deferred from the parser callbacks are resolved on the
+// worker pool in batches of this many.
+static const size_t def_batch_size = 65536;
+
 static void
 registerDefCallbacks();
 static int
@@ -33,6 +42,10 @@ defDesignCbk(defrCallbackType_e,
 	     const char *divider,
 	     defiUserData user);
 static int
+defDesignEndCbk(defrCallbackType_e,
+		void *,
+		defiUserData user);
+static int
 defDividerCbk(defrCallbackType_e,
 	      const char *divider,
 	      defiUserData user);
@@ -70,23 +83,69 @@ defToSta(const char *token,
 
 ////////////////////////////////////////////////////////////////
 
+// Component record captured from the parser callback with only the
+// fields the resizer consumes, so lean mode never copies the
+// defiComponent.
+class DefComponentRecord
+{
+public:
+  string name;
+  string macro_name;
+  DefDbu x;
+  DefDbu y;
+  int orient;
+  int status;
+  // Retained copy when saving def data, nullptr in lean mode.
+  defiComponent *def_component;
+  // Resolved by the workers.
+  Cell *cell;
+};
+
+// Net record captured from the parser callback. The parser owns and
+// reuses the defiNet, so the names are copied out and the hash
+// lookups deferred to the worker pool.
+class DefNetRecord
+{
+public:
+  string name;
+  // instance name ("PIN" for top level ports), pin name.
+  Vector<std::pair<string, string>> conns;
+  // Resolved by the workers; connect/makeTerm happen on the merge.
+  Vector<Instance*> insts;
+  Vector<Port*> ports;
+};
+
 // DEF parser callback routine state.
 class DefReader
 {
 public:
   DefReader(bool save_def_data,
+	    int thread_count,
 	    LefDefNetwork *network);
+  ~DefReader();
   bool saveDefData() { return save_def_data_; }
+  int threadCount() { return thread_count_; }
   LefDefNetwork *network() { return network_; }
+  // Pipelined construction: the parser thread defers copies of the
+  // records and the worker pool does the name lookups, with the
+  // network insertions merged serially batch by batch.
+  void deferComponent(defiComponent *def_component);
+  void deferNet(defiNet *def_net);
+  void flushComponents();
+  void flushNets();
 
 private:
   bool save_def_data_;
+  int thread_count_;
   LefDefNetwork *network_;
+  Vector<DefComponentRecord*> pending_components_;
+  Vector<DefNetRecord*> pending_nets_;
 };
 
 void
 readDef(const char *filename,
 	bool save_def_data,
+	int thread_count,
 	LefDefNetwork *network)
 {
   network->setDefFilename(filename);
@@ -96,13 +155,15 @@ readDef(const char *filename,
   if (lef_library) {
     defrInitSession();
     registerDefCallbacks();
-    DefReader reader(save_def_data, network);
+    DefReader reader(save_def_data, thread_count, network);
     FILE *stream = fopen(filename, "r");
     if (stream) {
       bool case_sensitive = true;
       defrRead(stream, filename, &reader, case_sensitive);
       defrClear();
       fclose(stream);
+      // Records edited from here on must be re-emitted by write_def.
+      network->trackDefEdits();
     }
     else
       throw FileNotReadable(filename);
@@ -115,6 +176,7 @@ static void
 registerDefCallbacks()
 {
   defrSetDesignCbk(defDesignCbk);
+  defrSetDesignEndCbk(defDesignEndCbk);
   defrSetDividerCbk(defDividerCbk);
   defrSetBusBitCbk(defBusBitCbk);
   defrSetUnitsCbk(defUnitsCbk);
@@ -126,12 +188,21 @@ registerDefCallbacks()
 }
 
 DefReader::DefReader(bool save_def_data,
+		     int thread_count,
 		     LefDefNetwork *network) :
   save_def_data_(save_def_data),
+  thread_count_(thread_count),
   network_(network)
 {
 }
 
+DefReader::~DefReader()
+{
+  // Normally drained by the section/design end callbacks.
+  flushComponents();
+  flushNets();
+}
+
 #define getDefReader(user) (reinterpret_cast<DefReader *>(user))
 #define getNetwork(user) (getDefReader(user)->network())
 #define saveDefData(user) (getDefReader(user)->saveDefData())
@@ -161,6 +232,17 @@ defDesignCbk(defrCallbackType_e,
   return 0;
 }
 
+static int
+defDesignEndCbk(defrCallbackType_e,
+		void *,
+		defiUserData user)
+{
+  DefReader *reader = getDefReader(user);
+  reader->flushComponents();
+  reader->flushNets();
+  return 0;
+}
+
 static int
 defDividerCbk(defrCallbackType_e,
 	      const char *divider,
@@ -211,27 +293,114 @@ defComponentCbk(defrCallbackType_e,
 		defiComponent *def_component,
 		defiUserData user)
 {
-  LefDefNetwork *network = getNetwork(user);
-  Library *lef_lib = network->lefLibrary();
-  const char *def_name = def_component->id();
-  const char *sta_name = defToSta(def_name, network);
-  const char *macro_name = def_component->name();
-  Cell *cell = network->findCell(lef_lib, macro_name);
-  if (cell)
-    network->makeDefComponent(cell, sta_name,
-			      saveDefData(user)
-			      ? new defiComponent(*def_component)
-			      : nullptr);
-  else
-    defError(user, "Error: component %s macro %s not found.\n", def_name, macro_name);
+  DefReader *reader = getDefReader(user);
+  if (reader->threadCount() > 1)
+    reader->deferComponent(def_component);
+  else {
+    LefDefNetwork *network = getNetwork(user);
+    Library *lef_lib = network->lefLibrary();
+    const char *def_name = def_component->id();
+    const char *sta_name = defToSta(def_name, network);
+    const char *macro_name = def_component->name();
+    Cell *cell = network->findCell(lef_lib, macro_name);
+    if (cell) {
+      // The parser object is only read when it is not retained.
+      bool save = saveDefData(user);
+      network->makeDefComponent(cell, sta_name,
+				save
+				? new defiComponent(*def_component)
+				: def_component,
+				save);
+    }
+    else
+      defError(user, "Error: component %s macro %s not found.\n", def_name, macro_name);
+  }
   return 0;
 }
 
+void
+DefReader::deferComponent(defiComponent *def_component)
+{
+  // The parser reuses the record after the callback returns.
+  DefComponentRecord *record = new DefComponentRecord;
+  record->name = def_component->id();
+  record->macro_name = def_component->name();
+  record->status = def_component->placementStatus();
+  if (record->status) {
+    record->x = def_component->placementX();
+    record->y = def_component->placementY();
+    record->orient = def_component->placementOrient();
+  }
+  else {
+    record->x = 0;
+    record->y = 0;
+    record->orient = 0;
+  }
+  record->def_component = save_def_data_
+    ? new defiComponent(*def_component)
+    : nullptr;
+  record->cell = nullptr;
+  pending_components_.push_back(record);
+  if (pending_components_.size() >= def_batch_size)
+    flushComponents();
+}
+
+void
+DefReader::flushComponents()
+{
+  size_t count = pending_components_.size();
+  if (count > 0) {
+    Library *lef_lib = network_->lefLibrary();
+    // Macro lookups only read the LEF library cell map.
+    std::atomic<size_t> next_index(0);
+    std::vector<std::thread> workers;
+    for (int t = 0; t < thread_count_; t++) {
+      workers.push_back(std::thread([&]() {
+	while (true) {
+	  size_t i = next_index.fetch_add(1);
+	  if (i >= count)
+	    break;
+	  DefComponentRecord *record = pending_components_[i];
+	  record->cell = network_->findCell(lef_lib,
+					    record->macro_name.c_str());
+	}
+      }));
+    }
+    for (auto &worker : workers)
+      worker.join();
+    // Merge into the network on the parser thread.
+    for (size_t i = 0; i < count; i++) {
+      DefComponentRecord *record = pending_components_[i];
+      const char *sta_name = defToSta(record->name.c_str(), network_);
+      if (record->cell) {
+	Instance *inst = network_->makeDefComponent(record->cell, sta_name,
+						    record->def_component,
+						    save_def_data_);
+	if (record->def_component == nullptr
+	    && record->status)
+	  network_->setLocation(inst, record->x, record->y,
+				record->orient, record->status);
+      }
+      else {
+	network_->report()->printError("Error: component %s macro %s not found.\n",
+				       record->name.c_str(),
+				       record->macro_name.c_str());
+	delete record->def_component;
+      }
+      delete record;
+    }
+    pending_components_.clear();
+  }
+}
+
 static int
 defPinCbk(defrCallbackType_e,
 	  defiPin *def_pin,
 	  defiUserData user)
 {
+  DefReader *reader = getDefReader(user);
+  // Nets connect to components, so drain them before the PINS section.
+  reader->flushComponents();
   LefDefNetwork *network = getNetwork(user);
   const char *pin_name = def_pin->pinName();
   // Make LEF ports in the top cell.
@@ -274,7 +443,7 @@ defPinEndCbk(defrCallbackType_e,
 {
   LefDefNetwork *network = getNetwork(user);
   network->initTopInstancePins();
-  Cell *top_cell = network->cell(network->topInstance());  
+  Cell *top_cell = network->cell(network->topInstance());
   network->groupBusPorts(top_cell);
   return 0;
 }
@@ -284,6 +453,12 @@ defNetCbk(defrCallbackType_e,
 	  defiNet *def_net,
 	  defiUserData user)
 {
+  DefReader *reader = getDefReader(user);
+  reader->flushComponents();
+  if (reader->threadCount() > 1) {
+    reader->deferNet(def_net);
+    return 0;
+  }
   LefDefNetwork *network = getNetwork(user);
   const char *def_net_name = def_net->name();
   const char *sta_net_name = defToSta(def_net_name, network);
@@ -331,6 +506,107 @@ defNetCbk(defrCallbackType_e,
   return 0;
 }
 
+void
+DefReader::deferNet(defiNet *def_net)
+{
+  DefNetRecord *record = new DefNetRecord;
+  record->name = def_net->name();
+  int conn_count = def_net->numConnections();
+  record->conns.reserve(conn_count);
+  for (int i = 0; i < conn_count; i++)
+    record->conns.push_back({def_net->instance(i), def_net->pin(i)});
+  pending_nets_.push_back(record);
+  if (pending_nets_.size() >= def_batch_size)
+    flushNets();
+}
+
+void
+DefReader::flushNets()
+{
+  size_t count = pending_nets_.size();
+  if (count > 0) {
+    Instance *top_inst = network_->topInstance();
+    // The component and port lookups dominate net construction and
+    // only read the network, so resolve them on the worker pool.
+    std::atomic<size_t> next_index(0);
+    std::vector<std::thread> workers;
+    for (int t = 0; t < thread_count_; t++) {
+      workers.push_back(std::thread([&]() {
+	while (true) {
+	  size_t i = next_index.fetch_add(1);
+	  if (i >= count)
+	    break;
+	  DefNetRecord *record = pending_nets_[i];
+	  size_t conn_count = record->conns.size();
+	  record->insts.resize(conn_count);
+	  record->ports.resize(conn_count);
+	  for (size_t c = 0; c < conn_count; c++) {
+	    const char *inst_name = record->conns[c].first.c_str();
+	    const char *pin_name = record->conns[c].second.c_str();
+	    if (stringEq(inst_name, "PIN")) {
+	      // Top level pins may be created during the merge.
+	      record->insts[c] = nullptr;
+	      record->ports[c] = nullptr;
+	    }
+	    else {
+	      const char *sta_inst_name = defToSta(inst_name, network_);
+	      Instance *inst = network_->findChild(top_inst, sta_inst_name);
+	      record->insts[c] = inst;
+	      record->ports[c] = inst
+		? network_->findPort(network_->cell(inst), pin_name)
+		: nullptr;
+	    }
+	  }
+	}
+      }));
+    }
+    for (auto &worker : workers)
+      worker.join();
+    // Merge into the network on the parser thread.
+    Report *report = network_->report();
+    for (size_t i = 0; i < count; i++) {
+      DefNetRecord *record = pending_nets_[i];
+      const char *def_net_name = record->name.c_str();
+      const char *sta_net_name = defToSta(def_net_name, network_);
+      Net *net = network_->makeNet(sta_net_name, top_inst);
+      for (size_t c = 0; c < record->conns.size(); c++) {
+	const char *inst_name = record->conns[c].first.c_str();
+	const char *pin_name = record->conns[c].second.c_str();
+	if (stringEq(inst_name, "PIN")) {
+	  Pin *pin = network_->findPin(top_inst, pin_name);
+	  if (pin == nullptr) {
+	    Cell *cell = network_->cell(top_inst);
+	    Port *port = network_->findPort(cell, pin_name);
+	    if (port)
+	      pin = network_->makePin(top_inst, port, nullptr);
+	    else
+	      report->printError("Error: net %s connection to PIN %s not found\n",
+				 def_net_name, pin_name);
+	  }
+	  if (pin)
+	    network_->makeTerm(pin, net);
+	}
+	else if (record->insts[c]) {
+	  if (record->ports[c])
+	    network_->connect(record->insts[c], record->ports[c], net);
+	  else
+	    report->printError("Error: net %s connection to component %s/%s pin %s not found.\n",
+			       def_net_name,
+			       inst_name,
+			       network_->name(network_->cell(record->insts[c])),
+			       pin_name);
+	}
+	else
+	  report->printError("Error: net %s connection component %s not found.\n",
+			     def_net_name,
+			     inst_name);
+      }
+      delete record;
+    }
+    pending_nets_.clear();
+  }
+}
+
 // Nada.
 // Note that the DEF names violate the normal sta namespace conventions
 // because the netlist is flattend.
@@ -24,6 +24,8 @@ class LefDefNetwork;
 void
 readDef(const char *filename,
 	bool save_def_data,
+	// Worker thread count for pipelined record construction.
+	int thread_count,
 	LefDefNetwork *network);
 
 } // namespace
@@ -1,21 +1,24 @@
 // Resizer, LEF/DEF gate resizer
 // Copyright (c) 2019, Parallax Software, Inc.
-// 
+//
 // This program is free software: you can redistribute it and/or modify
 // it under the terms of the GNU General Public License as published by
 // the Free Software Foundation, either version 3 of the License, or
 // (at your option) any later version.
-// 
+//
 // This program is distributed in the hope that it will be useful,
 // but WITHOUT ANY WARRANTY; without even the implied warranty of
 // MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
 // GNU General Public License for more details.
-// 
+//
 // You should have received a copy of the GNU General Public License
 // along with this program.  If not, see <https://www.gnu.org/licenses/>.
 
 #include <stdio.h>
 #include <stdlib.h>
+#include <stdarg.h>
+#include <ctype.h>
+#include <thread>
 #include <iostream>
 #include <fstream>
 #include "Machine.hh"
@@ -27,15 +30,22 @@
 #include "LefDefNetwork.hh"
 #include "NetworkCmp.hh"
 #include "defiComponent.hpp"
-#include "defiNet.hpp"
-#include "lefiLayer.hpp"
+#include "ResizerConfig.hh"  // ZLIB
 #include "DefWriter.hh"
 
+#if ZLIB
+#include <zlib.h>
+#endif
+
 namespace sta {
 
 using std::abs;
 using std::floor;
 using std::ifstream;
+using std::min;
+
+// Flush the output buffer with one large write when it grows past this.
+static const size_t buffer_flush_size = 1024 * 1024;
 
 class Track
 {
@@ -61,8 +71,15 @@ class DefWriter
 public:
   DefWriter(const char *filename,
 	    bool sort,
+	    int thread_count,
 	    LefDefNetwork *network);
   void rewrite(const char *in_filename);
+  void rewriteComponents(FILE *in_stream,
+			 char *&buffer,
+			 size_t &buffer_size);
+  void rewriteNets(FILE *in_stream,
+		   char *&buffer,
+		   size_t &buffer_size);
   void writeFresh(int units,
 		  double die_lx,
 		  double die_ly,
@@ -77,6 +94,10 @@ public:
 		  bool auto_place_pins);
 
 protected:
+  void openOutput();
+  void closeOutput();
+  void writeBuffer(const string &buf);
+  void flushOutput();
   void writeHeader(int units,
 		   // Die area.
 		   double die_lx,
@@ -99,7 +120,8 @@ protected:
 		      double die_ux,
 		      double die_uy);
   void writeComponents();
-  void writeComponent(Instance *inst);
+  void writeComponent(Instance *inst,
+		      string &buf);
   void writePins(double core_lx,
 		 double core_ly,
 		 double core_ux,
@@ -112,8 +134,10 @@ protected:
 		const char *orient);
   const char *staToDef(PortDirection *dir);
   void writeNets();
-  void writeNets(const Instance *inst);
-  void writeNet(Net *net);
+  void collectNets(const Instance *inst,
+		   NetSeq &nets);
+  void writeNet(Net *net,
+		string &buf);
   bool hasTerminals(Net *net) const;
   const char *staToDef(const char *token);
   DefDbu metersToDbu(double dist) const;
@@ -121,8 +145,14 @@ protected:
   const char *filename_;
   int def_units_;		// dbu/micron
   bool sort_;
+  int thread_count_;
   LefDefNetwork *network_;
   FILE *out_stream_;
+  string out_buf_;
+#if ZLIB
+  bool compressed_;
+  gzFile gz_stream_;
+#endif
   Vector<Track> tracks_;
 };
 
@@ -144,9 +174,10 @@ writeDef(const char *filename,
 	 const char *tracks_file,
 	 bool auto_place_pins,
 	 bool sort,
+	 int thread_count,
 	 LefDefNetwork *network)
 {
-  DefWriter writer(filename, sort, network);
+  DefWriter writer(filename, sort, thread_count, network);
   const char *in_filename = network->defFilename();
   if (in_filename)
     writer.rewrite(in_filename);
@@ -159,13 +190,178 @@ writeDef(const char *filename,
 
 DefWriter::DefWriter(const char *filename,
 		     bool sort,
+		     int thread_count,
 		     LefDefNetwork *network) :
   filename_(filename),
   sort_(sort),
-  network_(network)
+  thread_count_(thread_count),
+  network_(network),
+  out_stream_(nullptr)
+#if ZLIB
+  ,
+  compressed_(false),
+  gz_stream_(nullptr)
+#endif
+{
+}
+
+////////////////////////////////////////////////////////////////
+
+// Records are appended to in-memory buffers and written with large
+// sequential writes instead of a fprintf per token.
+static void
+appendPrint(string &buf,
+	    const char *fmt,
+	    ...)
 {
+  va_list args;
+  va_start(args, fmt);
+  char tmp[256];
+  int length = vsnprintf(tmp, sizeof(tmp), fmt, args);
+  va_end(args);
+  if (length < static_cast<int>(sizeof(tmp)))
+    buf += tmp;
+  else {
+    char *longer = new char[length + 1];
+    va_start(args, fmt);
+    vsnprintf(longer, length + 1, fmt, args);
+    va_end(args);
+    buf += longer;
+    delete [] longer;
+  }
 }
 
+// Network::pathName() returns temporary strings from a shared
+// circular pool, so shard workers build path names locally.
+static string
+staPathName(const Network *network,
+	    const Instance *inst)
+{
+  Instance *parent = network->parent(inst);
+  if (parent == nullptr
+      || parent == network->topInstance())
+    return network->name(inst);
+  else
+    return staPathName(network, parent)
+      + network->pathDivider()
+      + network->name(inst);
+}
+
+static string
+staPathName(const Network *network,
+	    const Net *net)
+{
+  Instance *parent = network->instance(net);
+  if (parent == nullptr
+      || parent == network->topInstance())
+    return network->name(net);
+  else
+    return staPathName(network, parent)
+      + network->pathDivider()
+      + network->name(net);
+}
+
+static string
+pinDefName(const Network *network,
+	   const Pin *pin)
+{
+  if (network->isTopLevelPort(pin))
+    return network->portName(pin);
+  else
+    return staPathName(network, network->instance(pin))
+      + network->pathDivider()
+      + network->portName(pin);
+}
+
+// DEF 5.x placement orientation encoding.
+static const char *
+defOrientStr(int orient)
+{
+  static const char *orient_strs[] =
+    {"N", "W", "S", "E", "FN", "FW", "FS", "FE"};
+  if (orient >= 0 && orient < 8)
+    return orient_strs[orient];
+  else
+    return "N";
+}
+
+// Thread-safe replacement for PinPathNameLess.
+class PinDefNameLess
+{
+public:
+  explicit PinDefNameLess(const Network *network) :
+    network_(network)
+  {
+  }
+  bool operator()(const Pin *pin1,
+		  const Pin *pin2) const
+  {
+    return pinDefName(network_, pin1) < pinDefName(network_, pin2);
+  }
+
+protected:
+  const Network *network_;
+};
+
+////////////////////////////////////////////////////////////////
+
+void
+DefWriter::openOutput()
+{
+#if ZLIB
+  size_t length = strlen(filename_);
+  compressed_ = length > 3
+    && stringEqual(&filename_[length - 3], ".gz");
+  if (compressed_) {
+    gz_stream_ = gzopen(filename_, "wb");
+    if (gz_stream_ == nullptr)
+      throw FileNotWritable(filename_);
+    return;
+  }
+#endif
+  out_stream_ = fopen(filename_, "w");
+  if (out_stream_ == nullptr)
+    throw FileNotWritable(filename_);
+}
+
+void
+DefWriter::writeBuffer(const string &buf)
+{
+  if (!buf.empty()) {
+#if ZLIB
+    if (compressed_) {
+      gzwrite(gz_stream_, buf.data(), buf.size());
+      return;
+    }
+#endif
+    fwrite(buf.data(), sizeof(char), buf.size(), out_stream_);
+  }
+}
+
+void
+DefWriter::flushOutput()
+{
+  writeBuffer(out_buf_);
+  out_buf_.clear();
+}
+
+void
+DefWriter::closeOutput()
+{
+  flushOutput();
+#if ZLIB
+  if (compressed_) {
+    gzclose(gz_stream_);
+    gz_stream_ = nullptr;
+    return;
+  }
+#endif
+  fclose(out_stream_);
+  out_stream_ = nullptr;
+}
+
+////////////////////////////////////////////////////////////////
+
 // Write a fresh DEF file from the network.
 void
 DefWriter::writeFresh(int units,
@@ -182,50 +378,54 @@ DefWriter::writeFresh(int units,
 		      const char *tracks_file,
 		      bool auto_place_pins)
 {
-  out_stream_ = fopen(filename_, "w");
-  if (out_stream_) {
-    def_units_ = units;
-    writeHeader(units, die_lx, die_ly, die_ux, die_uy);
-    fprintf(out_stream_, "\n");
+  openOutput();
+  def_units_ = units;
+  writeHeader(units, die_lx, die_ly, die_ux, die_uy);
+  out_buf_ += '\n';
 
-    writeRows(site_name, core_lx, core_ly, core_ux, core_uy);
-    fprintf(out_stream_, "\n");
+  writeRows(site_name, core_lx, core_ly, core_ux, core_uy);
+  out_buf_ += '\n';
 
-    if (tracks_file)
-      writeTracks(tracks_file, die_lx, die_ly, die_ux, die_uy);
-    else
-      writeLefTracks(die_lx, die_ly, die_ux, die_uy);
-    fprintf(out_stream_, "\n");
+  if (tracks_file)
+    writeTracks(tracks_file, die_lx, die_ly, die_ux, die_uy);
+  else
+    writeLefTracks(die_lx, die_ly, die_ux, die_uy);
+  out_buf_ += '\n';
 
-    writeComponents();
-    fprintf(out_stream_, "\n");
+  writeComponents();
+  out_buf_ += '\n';
 
-    writePins(core_lx, core_ly, core_ux, core_uy, auto_place_pins);
-    fprintf(out_stream_, "\n");
+  writePins(core_lx, core_ly, core_ux, core_uy, auto_place_pins);
+  out_buf_ += '\n';
 
-    writeNets();
-    fprintf(out_stream_, "\nEND DESIGN\n");
+  writeNets();
+  out_buf_ += "\nEND DESIGN\n";
 
-    fclose(out_stream_);
-  }
-  else
-    throw FileNotWritable(filename_);
+  closeOutput();
 }
 
 // The network came from a DEF file.
-// Preserve everything but the COMPONENT and NET sections by copying them
-// and replacing those sections.
+// Preserve everything but the COMPONENT and NET sections by copying
+// it. Untouched component and net records are copied from the input
+// verbatim; records edited or made since the read are re-emitted.
+// The records are emitted in the writer's order, so the output
+// matches a fresh write when the input records do.
 void
 DefWriter::rewrite(const char *in_filename)
 {
   FILE *in_stream = fopen(in_filename, "r");
   if (in_stream) {
-    out_stream_ = fopen(filename_, "w");
-    if (out_stream_) {
-      size_t buffer_size = 128;
-      char *buffer = new char[buffer_size];
-      while (getline(&buffer, &buffer_size, in_stream) >= 0) {
-	if (stringBeginEqual(buffer, "COMPONENTS ")) {
+    openOutput();
+    size_t buffer_size = 128;
+    char *buffer = new char[buffer_size];
+    while (getline(&buffer, &buffer_size, in_stream) >= 0) {
+      if (stringBeginEqual(buffer, "COMPONENTS ")) {
+	// -sort canonicalizes the record text and connection order,
+	// so sorted writes re-emit the whole section.
+	if (network_->defEditsTracked()
+	    && !sort_)
+	  rewriteComponents(in_stream, buffer, buffer_size);
+	else {
 	  // Skip the components.
 	  do {
 	    getline(&buffer, &buffer_size, in_stream);
@@ -233,7 +433,12 @@ DefWriter::rewrite(const char *in_filename)
 		   && !feof(in_stream));
 	  writeComponents();
 	}
-	else if (stringBeginEqual(buffer, "NETS ")) {
+      }
+      else if (stringBeginEqual(buffer, "NETS ")) {
+	if (network_->defEditsTracked()
+	    && !sort_)
+	  rewriteNets(in_stream, buffer, buffer_size);
+	else {
 	  // Skip the nets.
 	  do {
 	    getline(&buffer, &buffer_size, in_stream);
@@ -241,20 +446,146 @@ DefWriter::rewrite(const char *in_filename)
 		   && !feof(in_stream));
 	  writeNets();
 	}
-	else
-	  fputs(buffer, out_stream_);
       }
-      delete [] buffer;
-      fclose(out_stream_);
+      else {
+	out_buf_ += buffer;
+	if (out_buf_.size() > buffer_flush_size)
+	  flushOutput();
+      }
     }
-    else
-      throw FileNotWritable(filename_);
+    delete [] buffer;
+    closeOutput();
     fclose(in_stream);
   }
   else
     throw FileNotReadable(in_filename);
 }
 
+// DEF statements are terminated by a ';' token.
+static bool
+recordEnd(const string &record)
+{
+  for (auto iter = record.rbegin(); iter != record.rend(); iter++) {
+    char ch = *iter;
+    if (ch == ';')
+      return true;
+    if (!isspace(ch))
+      return false;
+  }
+  return false;
+}
+
+// Name token of a "- name ..." record, or "" for other section lines.
+static string
+recordName(const string &record)
+{
+  size_t begin = record.find_first_not_of(" \t");
+  if (begin != string::npos
+      && record[begin] == '-') {
+    begin = record.find_first_not_of(" \t", begin + 1);
+    if (begin != string::npos) {
+      size_t end = record.find_first_of(" \t\n", begin);
+      return record.substr(begin, end - begin);
+    }
+  }
+  return string();
+}
+
+void
+DefWriter::rewriteComponents(FILE *in_stream,
+			     char *&buffer,
+			     size_t &buffer_size)
+{
+  appendPrint(out_buf_, "COMPONENTS %d ;\n",
+	      network_->leafInstanceCount());
+  // Harvest the verbatim text of the unedited instance records.
+  // Deleted instances are dropped; edited ones are re-emitted below.
+  UnorderedMap<Instance*, string> records;
+  string record;
+  while (getline(&buffer, &buffer_size, in_stream) >= 0
+	 && !stringBeginEqual(buffer, "END COMPONENTS")) {
+    record = buffer;
+    // Records span lines up to the ';' terminator.
+    while (!recordEnd(record)
+	   && getline(&buffer, &buffer_size, in_stream) >= 0)
+      record += buffer;
+    string name = recordName(record);
+    if (name.empty())
+      // Not a component record; copy it.
+      out_buf_ += record;
+    else {
+      Instance *inst = network_->findInstance(name.c_str());
+      if (inst
+	  && !network_->defDirty(inst))
+	records[inst] = record;
+    }
+  }
+
+  // Emit the records in the same order as writeComponents so the
+  // output does not depend on the input record order.
+  LeafInstanceIterator *leaf_iter = network_->leafInstanceIterator();
+  while (leaf_iter->hasNext()) {
+    Instance *inst = leaf_iter->next();
+    auto found = records.find(inst);
+    if (found != records.end())
+      out_buf_ += found->second;
+    else
+      writeComponent(inst, out_buf_);
+    if (out_buf_.size() > buffer_flush_size)
+      flushOutput();
+  }
+  delete leaf_iter;
+
+  appendPrint(out_buf_, "END COMPONENTS\n");
+}
+
+void
+DefWriter::rewriteNets(FILE *in_stream,
+		       char *&buffer,
+		       size_t &buffer_size)
+{
+  appendPrint(out_buf_, "NETS %d ;\n",
+	      network_->netCount());
+  // Harvest the verbatim text of the unedited net records.
+  // Deleted nets are dropped; edited ones are re-emitted below.
+  UnorderedMap<Net*, string> records;
+  string record;
+  while (getline(&buffer, &buffer_size, in_stream) >= 0
+	 && !stringBeginEqual(buffer, "END NETS")) {
+    record = buffer;
+    // Records span lines up to the ';' terminator.
+    while (!recordEnd(record)
+	   && getline(&buffer, &buffer_size, in_stream) >= 0)
+      record += buffer;
+    string name = recordName(record);
+    if (name.empty())
+      // Not a net record; copy it.
+      out_buf_ += record;
+    else {
+      Net *net = network_->findNet(name.c_str());
+      if (net
+	  && !network_->defDirty(net))
+	records[net] = record;
+    }
+  }
+
+  // Emit the records in the same order as writeNets so the output
+  // does not depend on the input record order.
+  NetSeq nets;
+  collectNets(network_->topInstance(), nets);
+  for (auto net : nets) {
+    auto found = records.find(net);
+    if (found != records.end())
+      out_buf_ += found->second;
+    else
+      writeNet(net, out_buf_);
+    if (out_buf_.size() > buffer_flush_size)
+      flushOutput();
+  }
+
+  appendPrint(out_buf_, "END NETS\n");
+}
+
 void
 DefWriter::writeHeader(int units,
 		       // Die area.
@@ -263,18 +594,18 @@ DefWriter::writeHeader(int units,
 		       double die_ux,
 		       double die_uy)
 {
-  fprintf(out_stream_, "VERSION 5.7 ;\n");
-  fprintf(out_stream_, "NAMESCASESENSITIVE ON ;\n");
-  fprintf(out_stream_, "DIVIDERCHAR \"%c\" ;\n", network_->pathDivider());
-  fprintf(out_stream_, "BUSBITCHARS \"[]\" ;\n");
-  fprintf(out_stream_, "DESIGN %s ;\n",
-	  network_->name(network_->cell(network_->topInstance())));
-  fprintf(out_stream_, "UNITS DISTANCE MICRONS %d ;\n", units);
-  fprintf(out_stream_, "DIEAREA ( %d %d ) ( %d %d ) ;\n",
-	  metersToDbu(die_lx),
-	  metersToDbu(die_ly),
-	  metersToDbu(die_ux),
-	  metersToDbu(die_uy));
+  appendPrint(out_buf_, "VERSION 5.7 ;\n");
+  appendPrint(out_buf_, "NAMESCASESENSITIVE ON ;\n");
+  appendPrint(out_buf_, "DIVIDERCHAR \"%c\" ;\n", network_->pathDivider());
+  appendPrint(out_buf_, "BUSBITCHARS \"[]\" ;\n");
+  appendPrint(out_buf_, "DESIGN %s ;\n",
+	      network_->name(network_->cell(network_->topInstance())));
+  appendPrint(out_buf_, "UNITS DISTANCE MICRONS %d ;\n", units);
+  appendPrint(out_buf_, "DIEAREA ( %d %d ) ( %d %d ) ;\n",
+	      metersToDbu(die_lx),
+	      metersToDbu(die_ly),
+	      metersToDbu(die_ux),
+	      metersToDbu(die_uy));
 }
 
 void
@@ -287,7 +618,7 @@ DefWriter::writeRows(const char *site_name,
   Report *report = network_->report();
   if (site_name
       &&  core_lx >= 0.0 && core_lx >= 0.0 && core_ux >= 0.0 && core_uy >= 0.0) {
-    lefiSite *site = network_->findLefSite(site_name);
+    LefSite *site = network_->findLefSite(site_name);
     if (site) {
       if (site->hasSize()) {
 	// LEF site size is in microns. Convert to meters.
@@ -304,14 +635,14 @@ DefWriter::writeRows(const char *site_name,
 	int y = metersToDbu(core_ly);;
 	for (int row = 0; row < rows_y; row++) {
 	  const char *orient = (row % 2 == 0) ? "FS" : "N";
-	  fprintf(out_stream_, "ROW ROW_%d %s %d %d %s DO %d by 1 STEP %d 0 ;\n",
-		  row,
-		  site_name,
-		  core_lx_dbu,
-		  y,
-		  orient,
-		  rows_x,
-		  site_dx_dbu);
+	  appendPrint(out_buf_, "ROW ROW_%d %s %d %d %s DO %d by 1 STEP %d 0 ;\n",
+		      row,
+		      site_name,
+		      core_lx_dbu,
+		      y,
+		      orient,
+		      rows_x,
+		      site_dx_dbu);
 	  y += site_dy_dbu;
 	}
       }
@@ -343,12 +674,12 @@ DefWriter::writeTracks(const char *tracks_file,
     double width = (dir == 'X' ? width_x : width_y);
     int track_count = floor((width - offset) / pitch) + 1;
     // TRACKS Y 1600 DO 307 STEP 1600 LAYER M1 ;
-    fprintf(out_stream_, "TRACKS %c %d DO %d STEP %d LAYER %s ;\n",
-	    track.dir(),
-	    metersToDbu(offset),
-	    track_count,
-	    metersToDbu(pitch),
-	    track.layer().c_str());
+    appendPrint(out_buf_, "TRACKS %c %d DO %d STEP %d LAYER %s ;\n",
+		track.dir(),
+		metersToDbu(offset),
+		track_count,
+		metersToDbu(pitch),
+		track.layer().c_str());
   }
 }
 
@@ -415,6 +746,9 @@ DefWriter::writeLefTracks(double die_lx,
     if (layer.hasPitch()
 	&& layer.hasDirection()) {
       double pitch = layer.pitch() * 1e-6;
+      // The offset flag, not the offset value, giving one micron.
+      // Preserved because the track goldens depend on it; fixing it
+      // belongs with a golden regeneration.
       double offset = layer.hasOffset() ? layer.hasOffset() * 1e-6 : pitch;
       const char *lef_dir = layer.direction();
       char dir;
@@ -434,12 +768,12 @@ DefWriter::writeLefTracks(double die_lx,
       }
       int track_count = floor((width - offset) / pitch) + 1;
       // TRACKS Y 1600 DO 307 STEP 1600 LAYER M1 ;
-      fprintf(out_stream_, "TRACKS %c %d DO %d STEP %d LAYER %s ;\n",
-	      dir,
-	      metersToDbu(offset),
-	      track_count,
-	      metersToDbu(pitch),
-	      layer.name());
+      appendPrint(out_buf_, "TRACKS %c %d DO %d STEP %d LAYER %s ;\n",
+		  dir,
+		  metersToDbu(offset),
+		  track_count,
+		  metersToDbu(pitch),
+		  layer.name());
     }
   }
 }
@@ -449,8 +783,8 @@ DefWriter::writeLefTracks(double die_lx,
 void
 DefWriter::writeComponents()
 {
-  fprintf(out_stream_, "COMPONENTS %d ;\n",
-	  network_->leafInstanceCount());
+  appendPrint(out_buf_, "COMPONENTS %d ;\n",
+	      network_->leafInstanceCount());
 
   InstanceSeq insts;
   LeafInstanceIterator *leaf_iter = network_->leafInstanceIterator();
@@ -462,75 +796,104 @@ DefWriter::writeComponents()
 
   if (sort_)
     sort(insts, InstancePathNameLess(network_));
-  
-  for (auto inst : insts)
-    writeComponent(inst);
 
-  fprintf(out_stream_, "END COMPONENTS\n");
+  if (thread_count_ > 1) {
+    // Generate contiguous shards of the section on the worker pool
+    // and write them out in order.
+    Vector<string> shards(thread_count_);
+    size_t shard_size = (insts.size() + thread_count_ - 1) / thread_count_;
+    std::vector<std::thread> workers;
+    for (int t = 0; t < thread_count_; t++) {
+      workers.push_back(std::thread([&, t]() {
+	size_t begin = t * shard_size;
+	size_t end = min(begin + shard_size, insts.size());
+	for (size_t i = begin; i < end; i++)
+	  writeComponent(insts[i], shards[t]);
+      }));
+    }
+    for (auto &worker : workers)
+      worker.join();
+    flushOutput();
+    for (auto &shard : shards)
+      writeBuffer(shard);
+  }
+  else {
+    for (auto inst : insts) {
+      writeComponent(inst, out_buf_);
+      if (out_buf_.size() > buffer_flush_size)
+	flushOutput();
+    }
+  }
+
+  appendPrint(out_buf_, "END COMPONENTS\n");
 }
 
 void
-DefWriter::writeComponent(Instance *inst)
+DefWriter::writeComponent(Instance *inst,
+			  string &buf)
 {
   defiComponent *def_component = network_->defComponent(inst);
-  fprintf(out_stream_, "- %s %s",
-	  staToDef(network_->pathName(inst)),
-	  network_->name(network_->cell(inst)));
+  string inst_name = staPathName(network_, inst);
+  appendPrint(buf, "- %s %s",
+	      staToDef(inst_name.c_str()),
+	      network_->name(network_->cell(inst)));
   if (def_component) {
     if (def_component->hasEEQ())
-      fprintf(out_stream_, "\n+ EEQMASTER %s ", def_component->EEQ());
+      appendPrint(buf, "\n+ EEQMASTER %s ", def_component->EEQ());
     if (def_component->hasGenerate())
-      fprintf(out_stream_, "\n+ GENERATE %s %s",
-	      def_component->generateName(),
-	      def_component->macroName());
+      appendPrint(buf, "\n+ GENERATE %s %s",
+		  def_component->generateName(),
+		  def_component->macroName());
     if (def_component->hasSource())
-      fprintf(out_stream_, "\n+ SOURCE %s", def_component->source());
+      appendPrint(buf, "\n+ SOURCE %s", def_component->source());
     if (def_component->hasForeignName())
-      fprintf(out_stream_, "\n+ FOREIGN %s ( %d %d ) %s",
-	      def_component->foreignName(),
-	      def_component->foreignX(),
-	      def_component->foreignY(),
-	      def_component->foreignOri());
-    int status = def_component->placementStatus();
-    if (status) {
-      if (status == DEFI_COMPONENT_UNPLACED)
-	fprintf(out_stream_, "\n+ UNPLACED");
-      else {
-	const char *status_key;
-	switch (status) {
-	case DEFI_COMPONENT_PLACED:
-	  status_key = "PLACED";
-	  break;
-	case DEFI_COMPONENT_FIXED:
-	  status_key = "FIXED";
-	  break;
-	case DEFI_COMPONENT_COVER:
-	  status_key = "COVER";
-	  break;
-	}
-	fprintf(out_stream_, "\n+ %s ( %d %d ) %s",
-		status_key,
-		def_component->placementX(),
-		def_component->placementY(),
-		def_component->placementOrientStr());
-      }
-    }
+      appendPrint(buf, "\n+ FOREIGN %s ( %d %d ) %s",
+		  def_component->foreignName(),
+		  def_component->foreignX(),
+		  def_component->foreignY(),
+		  def_component->foreignOri());
     if (def_component->hasWeight())
-      fprintf(out_stream_, "\n+ WEIGHT %d",
-	      def_component->weight());
+      appendPrint(buf, "\n+ WEIGHT %d",
+		  def_component->weight());
     if (def_component->hasRegionName())
-      fprintf(out_stream_, "\n+ REGION %s",
-	      def_component->regionName());
+      appendPrint(buf, "\n+ REGION %s",
+		  def_component->regionName());
     if (def_component->hasRegionBounds()) {
       int size, *xl, *yl, *xh, *yh;
       def_component->regionBounds(&size, &xl, &yl, &xh, &yh);
-      fprintf(out_stream_, "\n+ REGION ( %d %d ) ( %d %d )",
-	      xl[0], yl[0], xh[0], yh[0]);
+      appendPrint(buf, "\n+ REGION ( %d %d ) ( %d %d )",
+		  xl[0], yl[0], xh[0], yh[0]);
     }
   }
-  fprintf(out_stream_, " ;\n");
+  // Placement comes from the network's compact location store, which
+  // also covers instances made after the DEF was read.
+  const InstanceLocation *loc = network_->instanceLocation(inst);
+  if (loc && loc->status_) {
+    if (loc->status_ == DEFI_COMPONENT_UNPLACED)
+      appendPrint(buf, "\n+ UNPLACED");
+    else {
+      const char *status_key;
+      switch (loc->status_) {
+      case DEFI_COMPONENT_PLACED:
+	status_key = "PLACED";
+	break;
+      case DEFI_COMPONENT_FIXED:
+	status_key = "FIXED";
+	break;
+      case DEFI_COMPONENT_COVER:
+	status_key = "COVER";
+	break;
+      }
+      appendPrint(buf, "\n+ %s ( %d %d ) %s",
+		  status_key,
+		  loc->x_,
+		  loc->y_,
+		  defOrientStr(loc->orient_));
+    }
+  }
+  appendPrint(buf, " ;\n");
 }
-  
+
 void
 DefWriter::writePins(double core_lx,
 		     double core_ly,
@@ -553,7 +916,7 @@ DefWriter::writePins(double core_lx,
     double location = 0.0;
     double pin_dist = perimeter / pin_count;
 
-    fprintf(out_stream_, "PINS %d ;\n", pin_count);
+    appendPrint(out_buf_, "PINS %d ;\n", pin_count);
     InstancePinIterator *pin_iter2 = network_->pinIterator(network_->topInstance());
     while (pin_iter2->hasNext()) {
       Pin *pin = pin_iter2->next();
@@ -587,8 +950,8 @@ DefWriter::writePins(double core_lx,
       location += pin_dist;
     }
     delete pin_iter2;
-  
-    fprintf(out_stream_, "END PINS\n");
+
+    appendPrint(out_buf_, "END PINS\n");
   }
 }
 
@@ -599,21 +962,21 @@ DefWriter::writePin(Pin *pin,
 		    double y,
 		    const char *orient)
 {
-  fprintf(out_stream_, "- %s",
-	  network_->pathName(pin));
+  appendPrint(out_buf_, "- %s",
+	      network_->pathName(pin));
   Net *net = network_->net(network_->term(pin));
   if (net)
-    fprintf(out_stream_, " + NET %s",
-	    network_->pathName(net));
+    appendPrint(out_buf_, " + NET %s",
+		network_->pathName(net));
   PortDirection *dir = network_->direction(network_->port(pin));
-  fprintf(out_stream_, " + DIRECTION %s",
-	  staToDef(dir));
+  appendPrint(out_buf_, " + DIRECTION %s",
+	      staToDef(dir));
   if (is_placed)
-    fprintf(out_stream_, " + FIXED ( %d %d ) %s",
-	    metersToDbu(x),
-	    metersToDbu(y),
-	    orient);
-  fprintf(out_stream_, " ;\n");
+    appendPrint(out_buf_, " + FIXED ( %d %d ) %s",
+		metersToDbu(x),
+		metersToDbu(y),
+		orient);
+  appendPrint(out_buf_, " ;\n");
 }
 
 const char *
@@ -634,16 +997,46 @@ DefWriter::staToDef(PortDirection *dir)
 void
 DefWriter::writeNets()
 {
-  fprintf(out_stream_, "NETS %d ;\n",
-	  network_->netCount());
-  writeNets(network_->topInstance());  
-  fprintf(out_stream_, "END NETS\n");
+  appendPrint(out_buf_, "NETS %d ;\n",
+	      network_->netCount());
+
+  NetSeq nets;
+  collectNets(network_->topInstance(), nets);
+
+  if (thread_count_ > 1) {
+    Vector<string> shards(thread_count_);
+    size_t shard_size = (nets.size() + thread_count_ - 1) / thread_count_;
+    std::vector<std::thread> workers;
+    for (int t = 0; t < thread_count_; t++) {
+      workers.push_back(std::thread([&, t]() {
+	size_t begin = t * shard_size;
+	size_t end = min(begin + shard_size, nets.size());
+	for (size_t i = begin; i < end; i++)
+	  writeNet(nets[i], shards[t]);
+      }));
+    }
+    for (auto &worker : workers)
+      worker.join();
+    flushOutput();
+    for (auto &shard : shards)
+      writeBuffer(shard);
+  }
+  else {
+    for (auto net : nets) {
+      writeNet(net, out_buf_);
+      if (out_buf_.size() > buffer_flush_size)
+	flushOutput();
+    }
+  }
+
+  appendPrint(out_buf_, "END NETS\n");
 }
 
 void
-DefWriter::writeNets(const Instance *inst)
+DefWriter::collectNets(const Instance *inst,
+		       NetSeq &nets)
 {
-  NetSeq nets;
+  NetSeq inst_nets;
   bool is_top = (inst == network_->topInstance());
   NetIterator *net_iter = network_->netIterator(inst);
   while (net_iter->hasNext()) {
@@ -651,22 +1044,22 @@ DefWriter::writeNets(const Instance *inst)
     if ((is_top || !hasTerminals(net))
 	&& !network_->isGround(net)
 	&& !network_->isPower(net))
-      nets.push_back(net);
+      inst_nets.push_back(net);
   }
   delete net_iter;
 
   if (sort_)
-    sort(nets, NetPathNameLess(network_));
+    sort(inst_nets, NetPathNameLess(network_));
 
-  for (auto net : nets)
-    writeNet(net);
+  for (auto net : inst_nets)
+    nets.push_back(net);
 
   // Decend the hierarchy.
   InstanceChildIterator *child_iter = network_->childIterator(inst);
   while (child_iter->hasNext()) {
     Instance *child = child_iter->next();
     if (network_->isHierarchical(child))
-      writeNets(child);
+      collectNets(child, nets);
   }
   delete child_iter;
 }
@@ -681,11 +1074,12 @@ DefWriter::hasTerminals(Net *net) const
 }
 
 void
-DefWriter::writeNet(Net *net)
+DefWriter::writeNet(Net *net,
+		    string &buf)
 {
-  const char *sta_net_name = network_->pathName(net);
-  const char *def_net_name = staToDef(sta_net_name);
-  fprintf(out_stream_, "- %s", def_net_name);
+  string sta_net_name = staPathName(network_, net);
+  const char *def_net_name = staToDef(sta_net_name.c_str());
+  appendPrint(buf, "- %s", def_net_name);
   int column = strlen(def_net_name) + 2;
   int column_max = 80;
 
@@ -698,32 +1092,32 @@ DefWriter::writeNet(Net *net)
   delete pin_iter;
 
   if (sort_)
-    sort(pins, PinPathNameLess(network_));
+    sort(pins, PinDefNameLess(network_));
 
   for (auto pin : pins) {
     int width = 0;
     if (network_->isTopLevelPort(pin)) {
       const char *port_name = network_->portName(pin);
-      fprintf(out_stream_, " ( PIN %s )",
-	      port_name);
+      appendPrint(buf, " ( PIN %s )",
+		  port_name);
       width = strlen(port_name) + 9;
     }
     else if (network_->isLeaf(pin)) {
-      const char *sta_component_name = network_->pathName(network_->instance(pin));
-      const char *def_component_name = staToDef(sta_component_name);
+      string sta_component_name = staPathName(network_, network_->instance(pin));
+      const char *def_component_name = staToDef(sta_component_name.c_str());
       const char *port_name = network_->portName(pin);
-      fprintf(out_stream_, " ( %s %s )",
-	      def_component_name,
-	      port_name);
+      appendPrint(buf, " ( %s %s )",
+		  def_component_name,
+		  port_name);
       width = strlen(def_component_name) + strlen(port_name) + 6;
     }
     if ((column + width) > column_max) {
-      fprintf(out_stream_, "\n ");
+      appendPrint(buf, "\n ");
       column = 0;
     }
     column += width;
   }
-  fprintf(out_stream_, " ;\n");
+  appendPrint(buf, " ;\n");
 }
 
 ////////////////////////////////////////////////////////////////
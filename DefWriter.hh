@@ -42,6 +42,8 @@ writeDef(const char *filename,
 	 // Place pins around the die area boundary.
 	 bool auto_place_pins,
 	 bool sort,
+	 // Worker thread count for section generation.
+	 int thread_count,
 	 LefDefNetwork *network);
 
 } // namespace
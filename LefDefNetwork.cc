@@ -14,7 +14,10 @@
 // You should have received a copy of the GNU General Public License
 // along with this program.  If not, see <https://www.gnu.org/licenses/>.
 
+#include <stdlib.h>
+#include <string.h>
 #include "Machine.hh"
+#include "StringUtil.hh"
 #include "Liberty.hh"
 #include "SdcNetwork.hh"
 #include "LefDefNetwork.hh"
@@ -22,12 +25,18 @@
 namespace sta {
 
 using std::round;
+using std::string;
 
 LefDefNetwork::LefDefNetwork() :
   ConcreteNetwork(),
   def_filename_(nullptr),
   lef_library_(nullptr),
-  manufacturing_grid_(0.0)
+  manufacturing_grid_(0.0),
+  design_area_(0.0),
+  design_area_valid_(false),
+  unique_net_index_(1),
+  unique_buffer_index_(1),
+  track_def_edits_(false)
 {
 }
 
@@ -43,10 +52,18 @@ LefDefNetwork::clear()
   def_filename_ = nullptr;
   lef_library_ = nullptr;
   def_component_map_.deleteContentsClear();
-  lef_macro_map_.deleteContents();
+  instance_locations_.clear();
+  lef_macro_size_map_.clear();
   lef_size_map_.deleteContents();
   manufacturing_grid_ = 0.0;
   lef_layers_.clear();
+  design_area_ = 0.0;
+  design_area_valid_ = false;
+  unique_net_index_ = 1;
+  unique_buffer_index_ = 1;
+  track_def_edits_ = false;
+  def_dirty_instances_.clear();
+  def_dirty_nets_.clear();
   ConcreteNetwork::clear();
 }
 
@@ -103,17 +120,35 @@ LefDefNetwork::makeLefLibrary(const char *name,
   return lef_library_;
 }
 
+LefMacroSize::LefMacroSize() :
+  size_x_(0.0),
+  size_y_(0.0)
+{
+}
+
+LefMacroSize::LefMacroSize(double size_x,
+			   double size_y) :
+  size_x_(size_x),
+  size_y_(size_y)
+{
+}
+
 void
-LefDefNetwork::setLefMacro(Cell *cell,
-			   lefiMacro *lef_macro)
+LefDefNetwork::setLefMacroSize(Cell *cell,
+			       double size_x,
+			       double size_y)
 {
-  lef_macro_map_[cell] = lef_macro;
+  lef_macro_size_map_[cell] = LefMacroSize(size_x, size_y);
 }
 
-lefiMacro *
-LefDefNetwork::lefMacro(Cell *cell) const
+const LefMacroSize *
+LefDefNetwork::lefMacroSize(Cell *cell) const
 {
-  return lef_macro_map_.findKey(cell);
+  auto size_iter = lef_macro_size_map_.find(cell);
+  if (size_iter == lef_macro_size_map_.end())
+    return nullptr;
+  else
+    return &size_iter->second;
 }
 
 Cell *
@@ -162,14 +197,34 @@ LefDefNetwork::initTopInstancePins()
   ctop_inst->initPins();
 }
 
+InstanceLocation::InstanceLocation() :
+  x_(0),
+  y_(0),
+  orient_(0),
+  status_(0)
+{
+}
+
 Instance *
 LefDefNetwork::makeDefComponent(Cell *cell,
 				const char *name,
-				defiComponent *def_component)
+				defiComponent *def_component,
+				bool save_def_data)
 {
   Instance *inst = makeInstance(cell, name, top_instance_);
-  if (def_component)
-    def_component_map_[inst] = def_component;
+  if (def_component) {
+    if (save_def_data)
+      def_component_map_[inst] = def_component;
+    // Copy the placement into the compact location store so the
+    // queries below never touch the parser object.
+    if (def_component->placementStatus()) {
+      InstanceLocation &loc = instance_locations_[inst];
+      loc.x_ = def_component->placementX();
+      loc.y_ = def_component->placementY();
+      loc.orient_ = def_component->placementOrient();
+      loc.status_ = def_component->placementStatus();
+    }
+  }
   return inst;
 }
 
@@ -183,25 +238,44 @@ void
 LefDefNetwork::setLocation(Instance *instance,
 			   DefPt location)
 {
-  defiComponent *def_component = defComponent(instance);
-  if (def_component == nullptr) {
-    def_component = new defiComponent(nullptr);
-    def_component_map_[instance] = def_component;
-  }
-  def_component->setPlacementStatus(DEFI_COMPONENT_PLACED);
-  def_component->setPlacementLocation(location.x(), location.y(), 0);
+  setLocation(instance, location.x(), location.y(), 0,
+	      DEFI_COMPONENT_PLACED);
+}
+
+void
+LefDefNetwork::setLocation(Instance *instance,
+			   DefDbu x,
+			   DefDbu y,
+			   int orient,
+			   int status)
+{
+  InstanceLocation &loc = instance_locations_[instance];
+  loc.x_ = x;
+  loc.y_ = y;
+  loc.orient_ = orient;
+  loc.status_ = status;
+  defEdited(instance);
+}
+
+const InstanceLocation *
+LefDefNetwork::instanceLocation(const Instance *inst) const
+{
+  auto loc_iter = instance_locations_.find(inst);
+  if (loc_iter == instance_locations_.end())
+    return nullptr;
+  else
+    return &loc_iter->second;
 }
 
 DefPt
 LefDefNetwork::location(const Pin *pin) const
 {
   Instance *inst = instance(pin);
-  defiComponent *def_component = def_component_map_.findKey(inst);
-  if (def_component
-      && def_component->isPlaced()) {
+  const InstanceLocation *loc = instanceLocation(inst);
+  if (loc
+      && loc->status_ == DEFI_COMPONENT_PLACED) {
     // Component location is good enough for now.
-    return DefPt(def_component->placementX(),
-		 def_component->placementY());
+    return DefPt(loc->x_, loc->y_);
   }
   else if (isTopLevelPort(pin)) {
     Port *port = this->port(pin);
@@ -221,6 +295,16 @@ LefDefNetwork::setLocation(Port *port,
   port_locations_[port] = location;
 }
 
+bool
+LefDefNetwork::portLocation(Port *port,
+			    // Return value.
+			    DefPt &location) const
+{
+  bool exists;
+  port_locations_.findKey(port, location, exists);
+  return exists;
+}
+
 bool
 LefDefNetwork::isPlaced(const Pin *pin) const
 {
@@ -228,9 +312,9 @@ LefDefNetwork::isPlaced(const Pin *pin) const
   if (inst == top_instance_)
     return port_locations_.hasKey(port(pin));
   else {
-    defiComponent *def_component = defComponent(inst);
-    return def_component
-      && def_component->isPlaced();
+    const InstanceLocation *loc = instanceLocation(inst);
+    return loc
+      && loc->status_ == DEFI_COMPONENT_PLACED;
   }
 }
 
@@ -248,14 +332,28 @@ LefDefNetwork::findNet(const char *path_name) const
 
 ////////////////////////////////////////////////////////////////
 
+LefSite::LefSite(const char *name,
+		 bool has_size,
+		 double size_x,
+		 double size_y) :
+  name_(name),
+  has_size_(has_size),
+  size_x_(size_x),
+  size_y_(size_y)
+{
+}
+
 void
-LefDefNetwork::makeLefSite(lefiSite *site)
+LefDefNetwork::makeLefSite(const char *name,
+			   bool has_size,
+			   double size_x,
+			   double size_y)
 {
-  lefiSite *copy = new lefiSite(*site);
-  lef_size_map_[copy->name()] = copy;
+  LefSite *site = new LefSite(name, has_size, size_x, size_y);
+  lef_size_map_[site->name()] = site;
 }
 
-lefiSite *
+LefSite *
 LefDefNetwork::findLefSite(const char *name)
 {
   return lef_size_map_.findKey(name);
@@ -263,10 +361,31 @@ LefDefNetwork::findLefSite(const char *name)
 
 ////////////////////////////////////////////////////////////////
 
+LefLayer::LefLayer(const char *name,
+		   const char *direction,
+		   bool has_pitch,
+		   double pitch,
+		   bool has_offset,
+		   double offset) :
+  name_(name),
+  direction_(direction),
+  has_pitch_(has_pitch),
+  pitch_(pitch),
+  has_offset_(has_offset),
+  offset_(offset)
+{
+}
+
 void
-LefDefNetwork::makeLefLayer(lefiLayer *layer)
+LefDefNetwork::makeLefLayer(const char *name,
+			    const char *direction,
+			    bool has_pitch,
+			    double pitch,
+			    bool has_offset,
+			    double offset)
 {
-  lef_layers_.push_back(*layer);
+  lef_layers_.push_back(LefLayer(name, direction, has_pitch, pitch,
+				 has_offset, offset));
 }
 
 ////////////////////////////////////////////////////////////////
@@ -274,14 +393,106 @@ LefDefNetwork::makeLefLayer(lefiLayer *layer)
 double
 LefDefNetwork::designArea()
 {
-  double design_area = 0.0;
-  LeafInstanceIterator *leaf_iter = leafInstanceIterator();
-  while (leaf_iter->hasNext()) {
-    Instance *leaf = leaf_iter->next();
-    design_area += area(leaf);
+  if (!design_area_valid_) {
+    design_area_ = 0.0;
+    LeafInstanceIterator *leaf_iter = leafInstanceIterator();
+    while (leaf_iter->hasNext()) {
+      Instance *leaf = leaf_iter->next();
+      design_area_ += area(leaf);
+    }
+    delete leaf_iter;
+    design_area_valid_ = true;
   }
-  delete leaf_iter;
-  return design_area;
+  return design_area_;
+}
+
+// Instance edits keep design_area_ current so designArea() never
+// rescans the network after the first request.
+Instance *
+LefDefNetwork::makeInstance(LibertyCell *cell,
+			    const char *name,
+			    Instance *parent)
+{
+  recordInstName(name);
+  Instance *inst = ConcreteNetwork::makeInstance(cell, name, parent);
+  if (design_area_valid_)
+    design_area_ += area(inst);
+  defEdited(inst);
+  return inst;
+}
+
+Instance *
+LefDefNetwork::makeInstance(Cell *cell,
+			    const char *name,
+			    Instance *parent)
+{
+  recordInstName(name);
+  Instance *inst = ConcreteNetwork::makeInstance(cell, name, parent);
+  if (design_area_valid_)
+    design_area_ += area(inst);
+  defEdited(inst);
+  return inst;
+}
+
+void
+LefDefNetwork::replaceCell(Instance *inst,
+			   Cell *to_cell)
+{
+  if (design_area_valid_)
+    design_area_ += area(to_cell) - area(cell(inst));
+  ConcreteNetwork::replaceCell(inst, to_cell);
+  defEdited(inst);
+}
+
+void
+LefDefNetwork::deleteInstance(Instance *inst)
+{
+  if (design_area_valid_)
+    design_area_ -= area(inst);
+  def_dirty_instances_.erase(inst);
+  // A later instance at the recycled address must not inherit the
+  // dead instance's placement or component record.
+  instance_locations_.erase(inst);
+  defiComponent *def_component = def_component_map_.findKey(inst);
+  if (def_component) {
+    delete def_component;
+    def_component_map_.erase(inst);
+  }
+  ConcreteNetwork::deleteInstance(inst);
+}
+
+Pin *
+LefDefNetwork::connect(Instance *inst,
+		       Port *port,
+		       Net *net)
+{
+  defEdited(net);
+  return ConcreteNetwork::connect(inst, port, net);
+}
+
+Pin *
+LefDefNetwork::connect(Instance *inst,
+		       LibertyPort *port,
+		       Net *net)
+{
+  defEdited(net);
+  return ConcreteNetwork::connect(inst, port, net);
+}
+
+void
+LefDefNetwork::disconnectPin(Pin *pin)
+{
+  Net *pin_net = net(pin);
+  if (pin_net)
+    defEdited(pin_net);
+  ConcreteNetwork::disconnectPin(pin);
+}
+
+void
+LefDefNetwork::deleteNet(Net *net)
+{
+  def_dirty_nets_.erase(net);
+  ConcreteNetwork::deleteNet(net);
 }
 
 double
@@ -290,6 +501,105 @@ LefDefNetwork::area(Instance *inst) const
   return area(cell(inst));
 }
 
+////////////////////////////////////////////////////////////////
+
+// Trailing integer of name when it is prefix<N>, or -1.
+static long
+prefixedIndex(const char *name,
+	      const char *prefix)
+{
+  size_t prefix_length = strlen(prefix);
+  if (strncmp(name, prefix, prefix_length) == 0) {
+    const char *suffix = name + prefix_length;
+    char *end;
+    long index = strtol(suffix, &end, 10);
+    if (end != suffix
+	&& *end == '\0')
+      return index;
+  }
+  return -1;
+}
+
+void
+LefDefNetwork::recordNetName(const char *name)
+{
+  long index = prefixedIndex(name, "net");
+  if (index >= unique_net_index_)
+    unique_net_index_ = index + 1;
+}
+
+void
+LefDefNetwork::recordInstName(const char *name)
+{
+  long index = prefixedIndex(name, "buffer");
+  if (index >= unique_buffer_index_)
+    unique_buffer_index_ = index + 1;
+}
+
+Net *
+LefDefNetwork::makeNet(const char *name,
+		       Instance *parent)
+{
+  recordNetName(name);
+  Net *net = ConcreteNetwork::makeNet(name, parent);
+  defEdited(net);
+  return net;
+}
+
+string
+LefDefNetwork::makeUniqueNetName()
+{
+  string net_name;
+  stringPrint(net_name, "net%d", unique_net_index_++);
+  return net_name;
+}
+
+string
+LefDefNetwork::makeUniqueBufferName()
+{
+  string buffer_name;
+  stringPrint(buffer_name, "buffer%d", unique_buffer_index_++);
+  return buffer_name;
+}
+
+////////////////////////////////////////////////////////////////
+
+// Called when the DEF read finishes; the records on disk and in the
+// network agree at that point.
+void
+LefDefNetwork::trackDefEdits()
+{
+  track_def_edits_ = true;
+  def_dirty_instances_.clear();
+  def_dirty_nets_.clear();
+}
+
+void
+LefDefNetwork::defEdited(Instance *inst)
+{
+  if (track_def_edits_)
+    def_dirty_instances_.insert(inst);
+}
+
+void
+LefDefNetwork::defEdited(Net *net)
+{
+  if (track_def_edits_)
+    def_dirty_nets_.insert(net);
+}
+
+bool
+LefDefNetwork::defDirty(Instance *inst) const
+{
+  return def_dirty_instances_.hasKey(inst);
+}
+
+bool
+LefDefNetwork::defDirty(Net *net) const
+{
+  return def_dirty_nets_.hasKey(net);
+}
+
 double
 LefDefNetwork::area(Cell *cell) const
 {
@@ -297,9 +607,9 @@ LefDefNetwork::area(Cell *cell) const
   if (lef_library_) {
     Cell *lef_cell = findCell(lef_library_, cell_name);
     if (lef_cell) {
-      lefiMacro *lef_macro = lefMacro(lef_cell);
-      if (lef_macro && lef_macro->hasSize())
-	return lef_macro->sizeX() * 1e-6 * lef_macro->sizeY() * 1e-6;
+      const LefMacroSize *size = lefMacroSize(lef_cell);
+      if (size)
+	return size->sizeX() * 1e-6 * size->sizeY() * 1e-6;
     }
   }
   return 0.0;
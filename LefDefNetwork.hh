@@ -17,13 +17,12 @@
 #ifndef RESIZER_LEF_DEF_NETWORK_H
 #define RESIZER_LEF_DEF_NETWORK_H
 
+#include <string>
+
 #include "UnorderedMap.hh"
 #include "ConcreteLibrary.hh"
 #include "ConcreteNetwork.hh"
-#include "lefiLayer.hpp"
-#include "lefiMacro.hpp"
 #include "defiComponent.hpp"
-#include "defiNet.hpp"
 
 namespace sta {
 
@@ -46,13 +45,92 @@ private:
   DefDbu y_;
 };
 
+// Compact placement record kept per instance so location queries do
+// not touch the heavyweight parser objects.
+class InstanceLocation
+{
+public:
+  InstanceLocation();
+  DefDbu x_;
+  DefDbu y_;
+  int orient_;
+  // DEFI_COMPONENT_* placement status (0 when unplaced).
+  int status_;
+};
+
+// Compact LEF records holding only the fields the resizer consumes,
+// extracted in the reader callbacks so the lefi parser objects are
+// not retained.
+class LefMacroSize
+{
+public:
+  LefMacroSize();
+  LefMacroSize(double size_x,
+	       double size_y);
+  // microns
+  double sizeX() const { return size_x_; }
+  double sizeY() const { return size_y_; }
+
+private:
+  double size_x_;
+  double size_y_;
+};
+
+class LefSite
+{
+public:
+  LefSite(const char *name,
+	  bool has_size,
+	  double size_x,
+	  double size_y);
+  const char *name() const { return name_.c_str(); }
+  bool hasSize() const { return has_size_; }
+  // microns
+  double sizeX() const { return size_x_; }
+  double sizeY() const { return size_y_; }
+
+private:
+  std::string name_;
+  bool has_size_;
+  double size_x_;
+  double size_y_;
+};
+
+class LefLayer
+{
+public:
+  LefLayer(const char *name,
+	   const char *direction,
+	   bool has_pitch,
+	   double pitch,
+	   bool has_offset,
+	   double offset);
+  const char *name() const { return name_.c_str(); }
+  bool hasDirection() const { return !direction_.empty(); }
+  const char *direction() const { return direction_.c_str(); }
+  bool hasPitch() const { return has_pitch_; }
+  // microns
+  double pitch() const { return pitch_; }
+  bool hasOffset() const { return has_offset_; }
+  double offset() const { return offset_; }
+
+private:
+  std::string name_;
+  std::string direction_;
+  bool has_pitch_;
+  double pitch_;
+  bool has_offset_;
+  double offset_;
+};
+
 // No need to specializing ConcreteLibrary at this point.
 typedef UnorderedMap<Cell*, LibertyCell*> LibertyCellMap;
 typedef UnorderedMap<Port*, DefPt> DefPortLocations;
+typedef UnorderedMap<const Instance*, InstanceLocation> InstanceLocationMap;
 typedef UnorderedMap<Instance*, defiComponent *> InstanceDefComponentMap;
-typedef UnorderedMap<Cell*, lefiMacro*> CellLefMacroMap;
-typedef Map<const char*, lefiSite*, CharPtrLess> LefSiteMap;
-typedef Vector<lefiLayer> LefLayerSeq;
+typedef UnorderedMap<Cell*, LefMacroSize> CellLefMacroSizeMap;
+typedef Map<const char*, LefSite*, CharPtrLess> LefSiteMap;
+typedef Vector<LefLayer> LefLayerSeq;
 
 class LefDefNetwork : public ConcreteNetwork
 {
@@ -79,15 +157,25 @@ public:
 			  const char *filename);
   Library *lefLibrary() const { return lef_library_; }
 
-  lefiSite *findLefSite(const char *name);
-  void makeLefSite(lefiSite *site);
+  LefSite *findLefSite(const char *name);
+  void makeLefSite(const char *name,
+		   bool has_size,
+		   double size_x,
+		   double size_y);
 
-  void makeLefLayer(lefiLayer *layer);
+  void makeLefLayer(const char *name,
+		    const char *direction,
+		    bool has_pitch,
+		    double pitch,
+		    bool has_offset,
+		    double offset);
   LefLayerSeq &lefLayers() { return lef_layers_; }
 
-  lefiMacro *lefMacro(Cell *cell) const;
-  void setLefMacro(Cell *cell,
-		   lefiMacro *lef_macro);
+  // Macro size (microns), or nullptr if the LEF macro has no SIZE.
+  const LefMacroSize *lefMacroSize(Cell *cell) const;
+  void setLefMacroSize(Cell *cell,
+		       double size_x,
+		       double size_y);
   Cell *lefCell(LibertyCell *cell);
   bool isLefCell(Cell *cell) const;
 
@@ -102,17 +190,31 @@ public:
 	       DefDbu &die_ux,
 	       DefDbu &die_uy);
   void initTopInstancePins();
+  // The placement is copied out of def_component; the record itself
+  // is only retained when save_def_data is true, which transfers
+  // ownership.
   Instance *makeDefComponent(Cell *cell,
 			     const char *name,
-			     defiComponent *def_component);
+			     defiComponent *def_component,
+			     bool save_def_data);
   defiComponent *defComponent(Instance *inst) const;
   // In DBUs.
   DefPt location(const Pin *pin) const;
+  const InstanceLocation *instanceLocation(const Instance *inst) const;
   void setLocation(Instance *instance,
 		   DefPt location);
+  // Full placement record, used when restoring saved placement.
+  void setLocation(Instance *instance,
+		   DefDbu x,
+		   DefDbu y,
+		   int orient,
+		   int status);
   // Set top level pin/port location.
   void setLocation(Port *port,
 		   DefPt location);
+  bool portLocation(Port *port,
+		    // Return value.
+		    DefPt &location) const;
   bool isPlaced(const Pin *pin) const;
   virtual Instance *findInstance(const char *path_name) const;
 
@@ -122,12 +224,52 @@ public:
 
   double area(Cell *cell) const;
   double area(Instance *inst) const;
+  // Incremental DEF rewrite support. Once the DEF read finishes the
+  // network records the instances and nets edited afterwards so
+  // write_def can copy the unchanged records from the input file
+  // verbatim instead of re-emitting the whole section.
+  void trackDefEdits();
+  bool defEditsTracked() const { return track_def_edits_; }
+  bool defDirty(Instance *inst) const;
+  bool defDirty(Net *net) const;
+  // Guaranteed-fresh names for resizer-made nets ("net<N>") and
+  // buffers ("buffer<N>") in O(1). The counters track the high-water
+  // mark of matching names as the design is built (DEF read,
+  // snapshot read, edits), so no find probing is needed.
+  std::string makeUniqueNetName();
+  std::string makeUniqueBufferName();
+  virtual Net *makeNet(const char *name,
+		       Instance *parent);
+  // Maintained incrementally by the instance edits below after the
+  // scan on the first request.
   double designArea();
+  virtual Instance *makeInstance(LibertyCell *cell,
+				 const char *name,
+				 Instance *parent);
+  Instance *makeInstance(Cell *cell,
+			 const char *name,
+			 Instance *parent);
+  virtual void replaceCell(Instance *inst,
+			   Cell *cell);
+  virtual void deleteInstance(Instance *inst);
+  virtual Pin *connect(Instance *inst,
+		       Port *port,
+		       Net *net);
+  virtual Pin *connect(Instance *inst,
+		       LibertyPort *port,
+		       Net *net);
+  virtual void disconnectPin(Pin *pin);
+  virtual void deleteNet(Net *net);
 
   using ConcreteNetwork::connect;
   using ConcreteNetwork::findNet;
 
 protected:
+  void recordNetName(const char *name);
+  void recordInstName(const char *name);
+  void defEdited(Instance *inst);
+  void defEdited(Net *net);
+
   const char *def_filename_;
   Library *lef_library_;
   int def_units_;		// dbu/micron
@@ -137,10 +279,18 @@ protected:
   DefDbu die_ux_;
   DefDbu die_uy_;
   DefPortLocations port_locations_;
+  InstanceLocationMap instance_locations_;
   InstanceDefComponentMap def_component_map_;
-  CellLefMacroMap lef_macro_map_;
+  CellLefMacroSizeMap lef_macro_size_map_;
   LefSiteMap lef_size_map_;
   LefLayerSeq lef_layers_;
+  double design_area_;
+  bool design_area_valid_;
+  int unique_net_index_;
+  int unique_buffer_index_;
+  bool track_def_edits_;
+  InstanceSet def_dirty_instances_;
+  NetSet def_dirty_nets_;
 };
 
 } // namespace
@@ -204,11 +204,12 @@ macroCbk(lefrCallbackType_e,
 	 lefiMacro *lef_macro,
 	 lefiUserData user)
 {
-  // Save lef macro data.
+  // Extract the macro size; the lefiMacro itself is not retained.
   LefReader *reader = getLefReader(user);
   LefDefNetwork *network = reader->network();
   Cell *cell = reader->lefMacro();
-  network->setLefMacro(cell, new lefiMacro(*lef_macro));
+  if (lef_macro->hasSize())
+    network->setLefMacroSize(cell, lef_macro->sizeX(), lef_macro->sizeY());
   return 0;
 }
 
@@ -250,7 +251,10 @@ lefSiteCbk(lefrCallbackType_e,
 {
   LefReader *reader = getLefReader(user);
   LefDefNetwork *network = reader->network();
-  network->makeLefSite(site);
+  bool has_size = site->hasSize();
+  network->makeLefSite(site->name(), has_size,
+		       has_size ? site->sizeX() : 0.0,
+		       has_size ? site->sizeY() : 0.0);
   return 0;
 }
 
@@ -261,7 +265,12 @@ lefLayerCbk(lefrCallbackType_e,
 {
   LefReader *reader = getLefReader(user);
   LefDefNetwork *network = reader->network();
-  network->makeLefLayer(layer);
+  network->makeLefLayer(layer->name(),
+			layer->hasDirection() ? layer->direction() : "",
+			layer->hasPitch(),
+			layer->hasPitch() ? layer->pitch() : 0.0,
+			layer->hasOffset(),
+			layer->hasOffset() ? layer->offset() : 0.0);
   return 0;
 }
 
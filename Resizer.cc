@@ -14,6 +14,14 @@
 // You should have received a copy of the GNU General Public License
 // along with this program.  If not, see <https://www.gnu.org/licenses/>.
 
+#include <stdio.h>
+#include <stdint.h>
+#include <sys/stat.h>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <mutex>
+#include <thread>
 #include "Machine.hh"
 #include "Report.hh"
 #include "Debug.hh"
@@ -23,6 +31,7 @@
 #include "Liberty.hh"
 #include "TimingArc.hh"
 #include "TimingModel.hh"
+#include "TableModel.hh"
 #include "Corner.hh"
 #include "DcalcAnalysisPt.hh"
 #include "Graph.hh"
@@ -37,7 +46,9 @@
 #include "LefDefNetwork.hh"
 #include "LefDefSdcNetwork.hh"
 #include "DefReader.hh"
+#include "Snapshot.hh"
 #include "SteinerTree.hh"
+#include "ResizerStats.hh"
 #include "Resizer.hh"
 
 // Outstanding issues
@@ -54,6 +65,7 @@
 namespace sta {
 
 using std::abs;
+using std::max;
 using std::min;
 using std::string;
 
@@ -66,16 +78,29 @@ Resizer::Resizer() :
   wire_res_(0.0),
   wire_cap_(0.0),
   corner_(nullptr),
+  have_parasitics_(false),
+  thread_count_(1),
   max_area_(0.0),
+  rebuffer_max_options_(0),
   clk_nets__valid_(false),
   level_drvr_verticies_valid_(false),
-  unique_net_index_(1),
-  unique_buffer_index_(1),
   core_area_(0.0),
-  design_area_(0.0)
+  rebuffer_option_arena_(nullptr),
+  stats_(new ResizerStats),
+  target_load_map_(nullptr)
 {
 }
 
+Resizer::~Resizer()
+{
+  delete stats_;
+  delete rebuffer_option_arena_;
+  target_load_cache_.deleteContents();
+  flat_arc_models_.deleteContents();
+  for (auto table : target_load_cell_tables_)
+    delete table;
+}
+
 void
 Resizer::makeNetwork()
 {
@@ -103,10 +128,12 @@ Resizer::makeCmdNetwork()
 }
 
 void
-Resizer::readDef(const char *filename)
+Resizer::readDef(const char *filename,
+		 bool lean)
 {
+  ResizerPhaseTimer timer(stats_, resizer_phase_def_read);
   LefDefNetwork *network = lefDefNetwork();
-  sta::readDef(filename, true, network);
+  sta::readDef(filename, !lean, thread_count_, network);
 
   DefDbu die_lx, die_ly, die_ux, die_uy;
   network->dieArea(die_lx, die_ly, die_ux, die_uy);
@@ -116,6 +143,37 @@ Resizer::readDef(const char *filename)
   double uy = network->dbuToMeters(die_uy);
   setDieSize(lx, ly, ux, uy);
   setCoreSize(lx, ly, ux, uy);
+  designChanged();
+}
+
+void
+Resizer::readSnapshot(const char *filename)
+{
+  LefDefNetwork *network = lefDefNetwork();
+  sta::readSnapshot(filename, network);
+
+  DefDbu die_lx, die_ly, die_ux, die_uy;
+  network->dieArea(die_lx, die_ly, die_ux, die_uy);
+  double lx = network->dbuToMeters(die_lx);
+  double ly = network->dbuToMeters(die_ly);
+  double ux = network->dbuToMeters(die_ux);
+  double uy = network->dbuToMeters(die_uy);
+  setDieSize(lx, ly, ux, uy);
+  setCoreSize(lx, ly, ux, uy);
+  designChanged();
+}
+
+// Drop state keyed by the previous design's objects when a new
+// design is loaded.
+void
+Resizer::designChanged()
+{
+  have_parasitics_ = false;
+  corner_ = nullptr;
+  steiner_tree_cache_.clear();
+  vertex_required_map_.clear();
+  level_drvr_verticies_valid_ = false;
+  clk_nets__valid_ = false;
 }
 
 ////////////////////////////////////////////////////////////////
@@ -209,16 +267,16 @@ Resizer::utilization()
 class VertexLevelLess
 {
 public:
-  VertexLevelLess(const Network *network);
+  VertexLevelLess(const Graph *graph);
   bool operator()(const Vertex *vertex1,
 		  const Vertex *vertex2) const;
 
 protected:
-  const Network *network_;
+  const Graph *graph_;
 };
 
-VertexLevelLess::VertexLevelLess(const Network *network) :
-  network_(network)
+VertexLevelLess::VertexLevelLess(const Graph *graph) :
+  graph_(graph)
 {
 }
 
@@ -230,9 +288,10 @@ VertexLevelLess::operator()(const Vertex *vertex1,
   Level level2 = vertex2->level();
   return (level1 < level2)
     || (level1 == level2
-	// Break ties for stable results.
-	&& stringLess(network_->pathName(vertex1->pin()),
-		      network_->pathName(vertex2->pin())));
+	// Break ties for stable results. The vertex id is stable for
+	// the life of the vertex and avoids the pathName() string
+	// compares of the old tiebreak.
+	&& graph_->id(vertex1) < graph_->id(vertex2));
 }
 
 
@@ -252,6 +311,13 @@ Resizer::setWireRC(float wire_res,
 		   float wire_cap,
 		   Corner *corner)
 {
+  // Repeat calls in multi-pass flows are incremental; only a change
+  // to the wire RC or corner invalidates the whole graph.
+  if (have_parasitics_
+      && wire_res == wire_res_
+      && wire_cap == wire_cap_
+      && corner == corner_)
+    return;
   // Disable incremental timing.
   graph_delay_calc_->delaysInvalid();
   search_->arrivalsInvalid();
@@ -262,6 +328,15 @@ Resizer::setWireRC(float wire_res,
   initCorner(corner);
   init();
   makeNetParasitics();
+  have_parasitics_ = true;
+}
+
+void
+Resizer::setThreadCount(int thread_count)
+{
+  if (thread_count < 1)
+    thread_count = 1;
+  thread_count_ = thread_count;
 }
 
 void
@@ -292,11 +367,27 @@ Resizer::ensureLevelDrvrVerticies()
       if (vertex->isDriver(network_))
 	level_drvr_verticies_.push_back(vertex);
     }
-    sort(level_drvr_verticies_, VertexLevelLess(network_));
+    sort(level_drvr_verticies_, VertexLevelLess(graph_));
     level_drvr_verticies_valid_ = true;
   }
 }
 
+// Add a driver vertex created by an edit to the list instead of
+// invalidating it, which costs a full vertex scan to rebuild.
+void
+Resizer::insertLevelDrvrVertex(Vertex *drvr_vertex)
+{
+  if (level_drvr_verticies_valid_) {
+    // Assign the new vertex's level. Relevelizing after the net edits
+    // that made the vertex can also move the levels of the existing
+    // vertices, so restore the sort rather than splicing into a
+    // possibly stale order.
+    ensureLevelized();
+    level_drvr_verticies_.push_back(drvr_vertex);
+    sort(level_drvr_verticies_, VertexLevelLess(graph_));
+  }
+}
+
 ////////////////////////////////////////////////////////////////
 
 void
@@ -305,6 +396,7 @@ Resizer::resizePreamble(LibertyLibrarySeq *resize_libs)
   init();
   makeEquivCells(resize_libs);
   findTargetLoads(resize_libs);
+  findTargetLoadCells();
 }
 
 ////////////////////////////////////////////////////////////////
@@ -339,18 +431,21 @@ Resizer::bufferInput(Pin *top_pin,
   string buffer_name = makeUniqueBufferName();
   Instance *parent = network->topInstance();
   Net *buffer_out = network->makeNet(buffer_out_net_name.c_str(), parent);
+  inheritClkNet(input_net, buffer_out);
   Instance *buffer = network->makeInstance(buffer_cell,
 					   buffer_name.c_str(),
 					   parent);
   network->setLocation(buffer, network->location(top_pin));
   inserted_buffer_count_++;
 
+  PinSeq load_pins;
   NetPinIterator *pin_iter(network->pinIterator(input_net));
   while (pin_iter->hasNext()) {
     Pin *pin = pin_iter->next();
-    disconnectPin(pin);
-    connectPin(network->instance(pin), network->port(pin), buffer_out);
+    load_pins.push_back(pin);
   }
+  delete pin_iter;
+  movePins(input_net, buffer_out, load_pins);
   connectPin(buffer, input, input_net);
   connectPin(buffer, output, buffer_out);
 }
@@ -383,42 +478,115 @@ Resizer::bufferOutput(Pin *top_pin,
   string buffer_name = makeUniqueBufferName();
   Instance *parent = network->topInstance();
   Net *buffer_in = network->makeNet(buffer_in_net_name.c_str(), parent);
+  inheritClkNet(output_net, buffer_in);
   Instance *buffer = network->makeInstance(buffer_cell,
 					   buffer_name.c_str(),
 					   parent);
   network->setLocation(buffer, network->location(top_pin));
   inserted_buffer_count_++;
 
+  PinSeq drvr_pins;
   NetPinIterator *pin_iter(network->pinIterator(output_net));
   while (pin_iter->hasNext()) {
     Pin *pin = pin_iter->next();
-    disconnectPin(pin);
-    connectPin(network->instance(pin), network->port(pin), buffer_in);
+    drvr_pins.push_back(pin);
   }
+  delete pin_iter;
+  movePins(output_net, buffer_in, drvr_pins);
   connectPin(buffer, input, buffer_in);
   connectPin(buffer, output, output_net);
 }
 
+// Move pins to another net with a single cache/timing invalidation
+// for both nets instead of one per disconnect/connect.
+void
+Resizer::movePins(Net *from,
+		  Net *to,
+		  PinSeq &pins)
+{
+  for (auto pin : pins) {
+    Instance *inst = network_->instance(pin);
+    Port *port = network_->port(pin);
+    Sta::disconnectPin(pin);
+    Sta::connectPin(inst, port, to);
+  }
+  steiner_tree_cache_.erase(from);
+  steiner_tree_cache_.erase(to);
+  requiredsInvalid(from);
+  requiredsInvalid(to);
+}
+
 ////////////////////////////////////////////////////////////////
 
 void
 Resizer::resizeToTargetSlew()
 {
+  ResizerPhaseTimer timer(stats_, resizer_phase_resize);
   resize_count_ = 0;
-  // Resize in reverse level order.
-  for (int i = level_drvr_verticies_.size() - 1; i >= 0; i--) {
-    Vertex *vertex = level_drvr_verticies_[i];
-    Pin *drvr_pin = vertex->pin();
-    Instance *inst = network_->instance(drvr_pin);
-    resizeToTargetSlew(inst);
-    if (overMaxArea()) {
-      report_->warn("max utilization reached.\n");
-      break;
+  // Clock net membership is read by the workers.
+  ensureClkNets();
+  if (thread_count_ > 1)
+    resizeToTargetSlewParallel();
+  else {
+    // Resize in reverse level order.
+    for (int i = level_drvr_verticies_.size() - 1; i >= 0; i--) {
+      Vertex *vertex = level_drvr_verticies_[i];
+      Pin *drvr_pin = vertex->pin();
+      Instance *inst = network_->instance(drvr_pin);
+      resizeToTargetSlew(inst);
+      if (overMaxArea()) {
+	report_->warn("max utilization reached.\n");
+	break;
+      }
     }
   }
   report_->print("Resized %d instances.\n", resize_count_);
 }
 
+// Drivers on the same level have no resizing order dependency; the
+// best cell search only reads the load cap, equiv cells and target
+// load map. Search each level on the worker pool and replace the
+// cells in a short serial commit phase before moving to the next
+// lower level.
+void
+Resizer::resizeToTargetSlewParallel()
+{
+  int i = static_cast<int>(level_drvr_verticies_.size()) - 1;
+  while (i >= 0) {
+    Level level = level_drvr_verticies_[i]->level();
+    InstanceSeq insts;
+    while (i >= 0
+	   && level_drvr_verticies_[i]->level() == level) {
+      Pin *drvr_pin = level_drvr_verticies_[i]->pin();
+      insts.push_back(network_->instance(drvr_pin));
+      i--;
+    }
+    Vector<LibertyCell*> best_cells(insts.size());
+    std::atomic<size_t> next_index(0);
+    std::vector<std::thread> workers;
+    for (int t = 0; t < thread_count_; t++) {
+      workers.push_back(std::thread([&]() {
+	while (true) {
+	  size_t j = next_index.fetch_add(1);
+	  if (j >= insts.size())
+	    break;
+	  best_cells[j] = findTargetCell(const_cast<Instance*>(insts[j]));
+	}
+      }));
+    }
+    for (auto &worker : workers)
+      worker.join();
+    for (size_t j = 0; j < insts.size(); j++) {
+      if (best_cells[j])
+	replaceTargetCell(const_cast<Instance*>(insts[j]), best_cells[j]);
+      if (overMaxArea()) {
+	report_->warn("max utilization reached.\n");
+	return;
+      }
+    }
+  }
+}
+
 void
 Resizer::makeEquivCells(LibertyLibrarySeq *resize_libs)
 {
@@ -435,6 +603,81 @@ Resizer::makeEquivCells(LibertyLibrarySeq *resize_libs)
 
 void
 Resizer::resizeToTargetSlew(Instance *inst)
+{
+  LibertyCell *best_cell = findTargetCell(inst);
+  if (best_cell)
+    replaceTargetCell(inst, best_cell);
+}
+
+// Equiv cell candidate and its target load, one entry of a table
+// sorted by target load.
+class TargetLoadCell
+{
+public:
+  TargetLoadCell(float target_load,
+		 LibertyCell *cell);
+  float targetLoad() const { return target_load_; }
+  LibertyCell *cell() const { return cell_; }
+
+private:
+  float target_load_;
+  LibertyCell *cell_;
+};
+
+TargetLoadCell::TargetLoadCell(float target_load,
+			       LibertyCell *cell) :
+  target_load_(target_load),
+  cell_(cell)
+{
+}
+
+// Build the per equiv class candidate tables of (target load, cell)
+// pre-filtered for dont_use and sorted by target load. Every member
+// of a class shares one table, so the best cell selection in
+// findTargetCell is a binary search instead of a scan over the
+// drive strengths.
+void
+Resizer::findTargetLoadCells()
+{
+  for (auto table : target_load_cell_tables_)
+    delete table;
+  target_load_cell_tables_.clear();
+  cell_target_load_cells_.clear();
+  LibertyLibraryIterator *lib_iter = network_->libertyLibraryIterator();
+  while (lib_iter->hasNext()) {
+    LibertyLibrary *library = lib_iter->next();
+    LibertyCellIterator cell_iter(library);
+    while (cell_iter.hasNext()) {
+      LibertyCell *cell = cell_iter.next();
+      if (!cell_target_load_cells_.hasKey(cell)) {
+	auto equiv_cells = equivCells(cell);
+	if (equiv_cells) {
+	  TargetLoadCellSeq *candidates = new TargetLoadCellSeq;
+	  for (auto equiv_cell : *equiv_cells) {
+	    if (!dontUse(equiv_cell))
+	      candidates->push_back(TargetLoadCell((*target_load_map_)[equiv_cell],
+						   equiv_cell));
+	  }
+	  sort(*candidates, [](const TargetLoadCell &candidate1,
+			       const TargetLoadCell &candidate2) {
+	    return candidate1.targetLoad() < candidate2.targetLoad();
+	  });
+	  target_load_cell_tables_.push_back(candidates);
+	  for (auto equiv_cell : *equiv_cells)
+	    cell_target_load_cells_[equiv_cell] = candidates;
+	}
+      }
+    }
+  }
+  delete lib_iter;
+}
+
+// Find the equivalent cell whose target load best matches the load
+// driven by inst, or nullptr if inst is already the best match.
+// Read-only with respect to the network, so instances on the same
+// level can be searched concurrently.
+LibertyCell *
+Resizer::findTargetCell(Instance *inst)
 {
   LefDefNetwork *network = lefDefNetwork();
   LibertyCell *cell = network_->libertyCell(inst);
@@ -447,46 +690,65 @@ Resizer::resizeToTargetSlew(Instance *inst)
       if (!isClock(out_net)) {
 	// Includes net parasitic capacitance.
 	float load_cap = graph_delay_calc_->loadCap(output, dcalc_ap_);
-	LibertyCell *best_cell = nullptr;
-	float best_ratio = 0.0;
-	auto equiv_cells = equivCells(cell);
-	if (equiv_cells) {
-	  for (auto target_cell : *equiv_cells) {
-	    if (!dontUse(target_cell)) {
-	      float target_load = (*target_load_map_)[target_cell];
-	      float ratio = target_load / load_cap;
-	      if (ratio > 1.0)
-		ratio = 1.0 / ratio;
-	      if (ratio > best_ratio) {
-		best_ratio = ratio;
-		best_cell = target_cell;
-	      }
-	    }
+	TargetLoadCellSeq *candidates = cell_target_load_cells_.findKey(cell);
+	if (candidates
+	    && !candidates->empty()) {
+	  // Find the first candidate with target load >= load_cap;
+	  // it and its lower neighbor bracket the best ratio.
+	  size_t lo = 0;
+	  size_t hi = candidates->size();
+	  while (lo < hi) {
+	    size_t mid = (lo + hi) / 2;
+	    if ((*candidates)[mid].targetLoad() < load_cap)
+	      lo = mid + 1;
+	    else
+	      hi = mid;
 	  }
-	  if (best_cell && best_cell != cell) {
-	    debugPrint3(debug_, "resizer", 2, "%s %s -> %s\n",
-			sdc_network_->pathName(inst),
-			cell->name(),
-			best_cell->name());
-	    if (network->isLefCell(network_->cell(inst))) {
-	      // Replace LEF with LEF so ports stay aligned in instance.
-	      Cell *best_lef = network->lefCell(best_cell);
-	      if (best_lef) {
-		design_area_ -= network->area(inst);
-		replaceCell(inst, best_lef);
-		resize_count_++;
-		design_area_ += network->area(inst);
-	      }
-	    }
-	    else {
-	      replaceCell(inst, best_cell);
-	      resize_count_++;
+	  LibertyCell *best_cell = nullptr;
+	  float best_ratio = 0.0;
+	  size_t first = (lo > 0) ? lo - 1 : lo;
+	  size_t last = min(lo, candidates->size() - 1);
+	  for (size_t i = first; i <= last; i++) {
+	    const TargetLoadCell &candidate = (*candidates)[i];
+	    float ratio = candidate.targetLoad() / load_cap;
+	    if (ratio > 1.0)
+	      ratio = 1.0 / ratio;
+	    if (ratio > best_ratio) {
+	      best_ratio = ratio;
+	      best_cell = candidate.cell();
 	    }
 	  }
+	  if (best_cell && best_cell != cell)
+	    return best_cell;
 	}
       }
     }
   }
+  return nullptr;
+}
+
+void
+Resizer::replaceTargetCell(Instance *inst,
+			   LibertyCell *best_cell)
+{
+  LefDefNetwork *network = lefDefNetwork();
+  LibertyCell *cell = network_->libertyCell(inst);
+  debugPrint3(debug_, "resizer", 2, "%s %s -> %s\n",
+	      sdc_network_->pathName(inst),
+	      cell->name(),
+	      best_cell->name());
+  if (network->isLefCell(network_->cell(inst))) {
+    // Replace LEF with LEF so ports stay aligned in instance.
+    Cell *best_lef = network->lefCell(best_cell);
+    if (best_lef) {
+      replaceCell(inst, best_lef);
+      resize_count_++;
+    }
+  }
+  else {
+    replaceCell(inst, best_cell);
+    resize_count_++;
+  }
 }
 
 static Pin *
@@ -519,7 +781,7 @@ Resizer::setMaxUtilization(double max_utilization)
 bool
 Resizer::overMaxArea()
 {
-  return max_area_ && design_area_ > max_area_;
+  return max_area_ && designArea() > max_area_;
 }
 
 void
@@ -528,6 +790,9 @@ Resizer::setDontUse(LibertyCellSeq *dont_use)
   if (dont_use) {
     for (auto cell : *dont_use)
       dont_use_.insert(cell);
+    // The candidate tables are pre-filtered for dont_use.
+    if (target_load_map_)
+      findTargetLoadCells();
   }
 }
 
@@ -540,17 +805,338 @@ Resizer::dontUse(LibertyCell *cell)
 
 ////////////////////////////////////////////////////////////////
 
+// One cache file per liberty library holds the buffer target slews
+// and per-cell target loads found by a previous run, so reloading the
+// same libraries skips the bisection searches. The cache is keyed by
+// the liberty file's modification time and the characterization PVT.
+// The cell target loads also depend on the target slew combined
+// across every resize library, so they are only reused when the
+// recorded slews match.
+class TargetLoadCacheEntry
+{
+public:
+  TargetLoadCacheEntry();
+  bool haveSlews() const { return have_slews_; }
+  void setSlews(Slew slews[],
+		int counts[]);
+  bool haveLoads(Slew tgt_slews[]) const;
+  void setLoads(LibertyLibrary *library,
+		CellTargetLoadMap *target_load_map,
+		Slew tgt_slews[]);
+
+  bool have_slews_;
+  Slew buffer_slews_[TransRiseFall::index_count];
+  int buffer_counts_[TransRiseFall::index_count];
+  bool have_loads_;
+  Slew tgt_slews_[TransRiseFall::index_count];
+  Vector<std::pair<string, float>> cell_loads_;
+};
+
+TargetLoadCacheEntry::TargetLoadCacheEntry() :
+  have_slews_(false),
+  have_loads_(false)
+{
+  for (auto tr : TransRiseFall::rangeIndex()) {
+    buffer_slews_[tr] = 0.0;
+    buffer_counts_[tr] = 0;
+    tgt_slews_[tr] = 0.0;
+  }
+}
+
+void
+TargetLoadCacheEntry::setSlews(Slew slews[],
+			       int counts[])
+{
+  for (auto tr : TransRiseFall::rangeIndex()) {
+    buffer_slews_[tr] = slews[tr];
+    buffer_counts_[tr] = counts[tr];
+  }
+  have_slews_ = true;
+}
+
+bool
+TargetLoadCacheEntry::haveLoads(Slew tgt_slews[]) const
+{
+  return have_loads_
+    && fuzzyEqual(tgt_slews_[TransRiseFall::riseIndex()],
+		  tgt_slews[TransRiseFall::riseIndex()])
+    && fuzzyEqual(tgt_slews_[TransRiseFall::fallIndex()],
+		  tgt_slews[TransRiseFall::fallIndex()]);
+}
+
+void
+TargetLoadCacheEntry::setLoads(LibertyLibrary *library,
+			       CellTargetLoadMap *target_load_map,
+			       Slew tgt_slews[])
+{
+  cell_loads_.clear();
+  LibertyCellIterator cell_iter(library);
+  while (cell_iter.hasNext()) {
+    LibertyCell *cell = cell_iter.next();
+    float load;
+    bool exists;
+    target_load_map->findKey(cell, load, exists);
+    if (exists)
+      cell_loads_.push_back({cell->name(), load});
+  }
+  for (auto tr : TransRiseFall::rangeIndex())
+    tgt_slews_[tr] = tgt_slews[tr];
+  have_loads_ = true;
+}
+
+static const uint32_t target_load_cache_magic = 0x52544743; // "RTGC"
+static const uint32_t target_load_cache_version = 1;
+
+static bool
+targetLoadCacheFilename(LibertyLibrary *library,
+			// Return values.
+			string &filename,
+			int64_t &lib_mtime)
+{
+  const char *lib_filename = library->filename();
+  if (lib_filename) {
+    struct stat status;
+    if (stat(lib_filename, &status) == 0) {
+      filename = lib_filename;
+      filename += ".tgt";
+      lib_mtime = status.st_mtime;
+      return true;
+    }
+  }
+  return false;
+}
+
+static bool
+readCacheUint32(FILE *stream,
+		uint32_t &value)
+{
+  return fread(&value, sizeof(value), 1, stream) == 1;
+}
+
+static bool
+readCacheInt64(FILE *stream,
+	       int64_t &value)
+{
+  return fread(&value, sizeof(value), 1, stream) == 1;
+}
+
+static bool
+readCacheFloat(FILE *stream,
+	       float &value)
+{
+  return fread(&value, sizeof(value), 1, stream) == 1;
+}
+
+static bool
+readCacheString(FILE *stream,
+		string &value)
+{
+  uint32_t length;
+  if (readCacheUint32(stream, length)
+      // Sanity limit for corrupted files.
+      && length < 1000) {
+    value.resize(length);
+    return length == 0
+      || fread(&value[0], sizeof(char), length, stream) == length;
+  }
+  return false;
+}
+
+static void
+writeCacheUint32(FILE *stream,
+		 uint32_t value)
+{
+  fwrite(&value, sizeof(value), 1, stream);
+}
+
+static void
+writeCacheInt64(FILE *stream,
+		int64_t value)
+{
+  fwrite(&value, sizeof(value), 1, stream);
+}
+
+static void
+writeCacheFloat(FILE *stream,
+		float value)
+{
+  fwrite(&value, sizeof(value), 1, stream);
+}
+
+static void
+writeCacheString(FILE *stream,
+		 const string &value)
+{
+  writeCacheUint32(stream, value.size());
+  fwrite(value.data(), sizeof(char), value.size(), stream);
+}
+
+TargetLoadCacheEntry *
+Resizer::readTargetLoadCache(LibertyLibrary *library)
+{
+  TargetLoadCacheEntry *entry = new TargetLoadCacheEntry;
+  string filename;
+  int64_t lib_mtime;
+  if (targetLoadCacheFilename(library, filename, lib_mtime)) {
+    FILE *stream = fopen(filename.c_str(), "rb");
+    if (stream) {
+      float pvt_process = pvt_ ? pvt_->process() : 0.0;
+      float pvt_voltage = pvt_ ? pvt_->voltage() : 0.0;
+      float pvt_temp = pvt_ ? pvt_->temperature() : 0.0;
+      uint32_t magic, version, cell_count;
+      int64_t mtime;
+      float process, voltage, temp;
+      Slew slews[TransRiseFall::index_count];
+      int counts[TransRiseFall::index_count];
+      bool ok = readCacheUint32(stream, magic)
+	&& magic == target_load_cache_magic
+	&& readCacheUint32(stream, version)
+	&& version == target_load_cache_version
+	&& readCacheInt64(stream, mtime)
+	&& mtime == lib_mtime
+	&& readCacheFloat(stream, process)
+	&& fuzzyEqual(process, pvt_process)
+	&& readCacheFloat(stream, voltage)
+	&& fuzzyEqual(voltage, pvt_voltage)
+	&& readCacheFloat(stream, temp)
+	&& fuzzyEqual(temp, pvt_temp);
+      for (auto tr : TransRiseFall::rangeIndex()) {
+	float slew;
+	uint32_t count;
+	ok = ok
+	  && readCacheFloat(stream, slew)
+	  && readCacheUint32(stream, count);
+	if (ok) {
+	  slews[tr] = slew;
+	  counts[tr] = count;
+	}
+      }
+      if (ok) {
+	entry->setSlews(slews, counts);
+	debugPrint1(debug_, "resizer", 2, "target slew cache hit %s\n",
+		    library->name());
+      }
+      for (auto tr : TransRiseFall::rangeIndex()) {
+	float slew;
+	ok = ok && readCacheFloat(stream, slew);
+	if (ok)
+	  entry->tgt_slews_[tr] = slew;
+      }
+      ok = ok && readCacheUint32(stream, cell_count);
+      if (ok) {
+	for (uint32_t i = 0; i < cell_count && ok; i++) {
+	  string cell_name;
+	  float load;
+	  ok = readCacheString(stream, cell_name)
+	    && readCacheFloat(stream, load);
+	  if (ok)
+	    entry->cell_loads_.push_back({cell_name, load});
+	}
+	entry->have_loads_ = ok;
+      }
+      fclose(stream);
+    }
+  }
+  return entry;
+}
+
+void
+Resizer::writeTargetLoadCache(LibertyLibrary *library,
+			      TargetLoadCacheEntry *entry)
+{
+  string filename;
+  int64_t lib_mtime;
+  if (targetLoadCacheFilename(library, filename, lib_mtime)) {
+    FILE *stream = fopen(filename.c_str(), "wb");
+    // Silently skip the cache if the library directory is not writable.
+    if (stream) {
+      writeCacheUint32(stream, target_load_cache_magic);
+      writeCacheUint32(stream, target_load_cache_version);
+      writeCacheInt64(stream, lib_mtime);
+      writeCacheFloat(stream, pvt_ ? pvt_->process() : 0.0);
+      writeCacheFloat(stream, pvt_ ? pvt_->voltage() : 0.0);
+      writeCacheFloat(stream, pvt_ ? pvt_->temperature() : 0.0);
+      for (auto tr : TransRiseFall::rangeIndex()) {
+	writeCacheFloat(stream, entry->buffer_slews_[tr]);
+	writeCacheUint32(stream, entry->buffer_counts_[tr]);
+      }
+      for (auto tr : TransRiseFall::rangeIndex())
+	writeCacheFloat(stream, entry->tgt_slews_[tr]);
+      writeCacheUint32(stream, entry->cell_loads_.size());
+      for (auto &cell_load : entry->cell_loads_) {
+	writeCacheString(stream, cell_load.first);
+	writeCacheFloat(stream, cell_load.second);
+      }
+      fclose(stream);
+    }
+  }
+}
+
+////////////////////////////////////////////////////////////////
+
 // Find a target slew for the libraries and then
 // a target load for each cell that gives the target slew.
 void
 Resizer::findTargetLoads(LibertyLibrarySeq *resize_libs)
 {
+  ResizerPhaseTimer timer(stats_, resizer_phase_target_loads);
+  for (auto lib : *resize_libs) {
+    if (!target_load_cache_.hasKey(lib))
+      target_load_cache_[lib] = readTargetLoadCache(lib);
+  }
   // Find target slew across all buffers in the libraries.
   findBufferTargetSlews(resize_libs);
   if (target_load_map_ == nullptr)
     target_load_map_ = new CellTargetLoadMap;
-  for (auto lib : *resize_libs)
-    findTargetLoads(lib, tgt_slews_);
+  for (auto lib : *resize_libs) {
+    TargetLoadCacheEntry *entry = target_load_cache_[lib];
+    if (entry->haveLoads(tgt_slews_)) {
+      debugPrint1(debug_, "resizer", 2, "target load cache hit %s\n",
+		  lib->name());
+      for (auto &cell_load : entry->cell_loads_) {
+	LibertyCell *cell = lib->findLibertyCell(cell_load.first.c_str());
+	if (cell)
+	  (*target_load_map_)[cell] = cell_load.second;
+      }
+    }
+    else {
+      if (thread_count_ > 1)
+	findTargetLoadsParallel(lib);
+      else
+	findTargetLoads(lib, tgt_slews_);
+      entry->setLoads(lib, target_load_map_, tgt_slews_);
+      writeTargetLoadCache(lib, entry);
+    }
+  }
+}
+
+// The per-cell bisections are pure functions of the liberty data, so
+// characterize the cells on a worker pool and merge the results into
+// target_load_map_ with a single insertion pass.
+void
+Resizer::findTargetLoadsParallel(LibertyLibrary *library)
+{
+  LibertyCellSeq cells;
+  LibertyCellIterator cell_iter(library);
+  while (cell_iter.hasNext())
+    cells.push_back(cell_iter.next());
+  Vector<float> target_loads(cells.size());
+  std::atomic<size_t> next_index(0);
+  std::vector<std::thread> workers;
+  for (int i = 0; i < thread_count_; i++) {
+    workers.push_back(std::thread([&]() {
+      while (true) {
+	size_t j = next_index.fetch_add(1);
+	if (j >= cells.size())
+	  break;
+	target_loads[j] = findTargetLoad(cells[j], tgt_slews_);
+      }
+    }));
+  }
+  for (auto &worker : workers)
+    worker.join();
+  for (size_t j = 0; j < cells.size(); j++)
+    (*target_load_map_)[cells[j]] = target_loads[j];
 }
 
 float
@@ -569,11 +1155,213 @@ Resizer::findTargetLoads(LibertyLibrary *library,
   LibertyCellIterator cell_iter(library);
   while (cell_iter.hasNext()) {
     auto cell = cell_iter.next();
-    findTargetLoad(cell, slews);
+    (*target_load_map_)[cell] = findTargetLoad(cell, slews);
   }
 }
 
+////////////////////////////////////////////////////////////////
+
+// Flattened copy of an NLDM table: contiguous axis and value arrays
+// evaluated by bilinear interpolation, avoiding the virtual
+// GateTimingModel dispatch and pointer chasing in inner loops.
+// Only tables over input slew and load capacitance (in either axis
+// order) flatten; other forms fall back to the timing model.
+class FlatTable
+{
+public:
+  bool init(const TableModel *table);
+  float eval(float in_slew,
+	     float load_cap) const;
+
+private:
+  static void findInterval(const Vector<float> &axis,
+			   float x,
+			   // Return values.
+			   size_t &index,
+			   float &fraction);
+  static bool isSlewVariable(TableAxisVariable var);
+  static bool isCapVariable(TableAxisVariable var);
+
+  Vector<float> slew_axis_;
+  Vector<float> cap_axis_;
+  // Row major, slew axis outermost.
+  Vector<float> values_;
+};
+
+bool
+FlatTable::isSlewVariable(TableAxisVariable var)
+{
+  return var == TableAxisVariable::input_transition_time
+    || var == TableAxisVariable::input_net_transition;
+}
+
+bool
+FlatTable::isCapVariable(TableAxisVariable var)
+{
+  return var == TableAxisVariable::total_output_net_capacitance;
+}
+
+bool
+FlatTable::init(const TableModel *table)
+{
+  switch (table->order()) {
+  case 0:
+    values_.push_back(table->value(0, 0, 0));
+    return true;
+  case 1: {
+    TableAxis *axis = table->axis1();
+    Vector<float> *axis_values;
+    if (isSlewVariable(axis->variable()))
+      axis_values = &slew_axis_;
+    else if (isCapVariable(axis->variable()))
+      axis_values = &cap_axis_;
+    else
+      return false;
+    for (size_t i = 0; i < axis->size(); i++) {
+      axis_values->push_back(axis->axisValue(i));
+      values_.push_back(table->value(i, 0, 0));
+    }
+    return true;
+  }
+  case 2: {
+    TableAxis *axis1 = table->axis1();
+    TableAxis *axis2 = table->axis2();
+    bool slew_first;
+    if (isSlewVariable(axis1->variable())
+	&& isCapVariable(axis2->variable()))
+      slew_first = true;
+    else if (isCapVariable(axis1->variable())
+	     && isSlewVariable(axis2->variable()))
+      slew_first = false;
+    else
+      return false;
+    TableAxis *slew_axis = slew_first ? axis1 : axis2;
+    TableAxis *cap_axis = slew_first ? axis2 : axis1;
+    for (size_t i = 0; i < slew_axis->size(); i++)
+      slew_axis_.push_back(slew_axis->axisValue(i));
+    for (size_t i = 0; i < cap_axis->size(); i++)
+      cap_axis_.push_back(cap_axis->axisValue(i));
+    values_.resize(slew_axis_.size() * cap_axis_.size());
+    for (size_t s = 0; s < slew_axis_.size(); s++) {
+      for (size_t c = 0; c < cap_axis_.size(); c++)
+	values_[s * cap_axis_.size() + c] =
+	  slew_first ? table->value(s, c, 0) : table->value(c, s, 0);
+    }
+    return true;
+  }
+  default:
+    return false;
+  }
+}
+
+// Lower interval index and unclamped fraction, so values outside the
+// axis extrapolate linearly like TableModel.
 void
+FlatTable::findInterval(const Vector<float> &axis,
+			float x,
+			// Return values.
+			size_t &index,
+			float &fraction)
+{
+  size_t size = axis.size();
+  if (size < 2) {
+    index = 0;
+    fraction = 0.0;
+  }
+  else {
+    size_t upper = std::upper_bound(axis.begin(), axis.end(), x)
+      - axis.begin();
+    index = min(max(upper, static_cast<size_t>(1)), size - 1) - 1;
+    fraction = (x - axis[index]) / (axis[index + 1] - axis[index]);
+  }
+}
+
+float
+FlatTable::eval(float in_slew,
+		float load_cap) const
+{
+  size_t slew_index, cap_index;
+  float slew_frac, cap_frac;
+  findInterval(slew_axis_, in_slew, slew_index, slew_frac);
+  findInterval(cap_axis_, load_cap, cap_index, cap_frac);
+  size_t cap_stride = max(cap_axis_.size(), static_cast<size_t>(1));
+  size_t slew_next = slew_axis_.size() < 2 ? 0 : cap_stride;
+  size_t cap_next = cap_axis_.size() < 2 ? 0 : 1;
+  const float *row = &values_[slew_index * cap_stride + cap_index];
+  float v00 = row[0];
+  float v01 = row[cap_next];
+  float v10 = row[slew_next];
+  float v11 = row[slew_next + cap_next];
+  float v0 = v00 + cap_frac * (v01 - v00);
+  float v1 = v10 + cap_frac * (v11 - v10);
+  return v0 + slew_frac * (v1 - v0);
+}
+
+// Flattened delay/slew surfaces for one timing arc.
+class FlatArcModel
+{
+public:
+  bool init(LibertyCell *cell,
+	    TimingArc *arc,
+	    const Pvt *pvt);
+  float delay(float in_slew,
+	      float load_cap) const { return delay_.eval(in_slew, load_cap); }
+  float slew(float in_slew,
+	     float load_cap) const { return slew_.eval(in_slew, load_cap); }
+
+private:
+  FlatTable delay_;
+  FlatTable slew_;
+};
+
+bool
+FlatArcModel::init(LibertyCell *cell,
+		   TimingArc *arc,
+		   const Pvt *pvt)
+{
+  GateTableModel *model = dynamic_cast<GateTableModel*>(arc->model());
+  if (model
+      && model->delayModel()
+      && model->slewModel()
+      && delay_.init(model->delayModel())
+      && slew_.init(model->slewModel())) {
+    // Probe the model; a mismatch means it applies scale factor
+    // derating the flat tables do not capture.
+    float in_slew = .5e-9;
+    float load_cap = 1.0e-13;
+    ArcDelay arc_delay;
+    Slew arc_slew;
+    model->gateDelay(cell, pvt, in_slew, load_cap, 0.0, false,
+		     arc_delay, arc_slew);
+    return fuzzyEqual(arc_delay, delay(in_slew, load_cap))
+      && fuzzyEqual(arc_slew, slew(in_slew, load_cap));
+  }
+  return false;
+}
+
+FlatArcModel *
+Resizer::flatArcModel(LibertyCell *cell,
+		      TimingArc *arc)
+{
+  std::lock_guard<std::mutex> lock(flat_arc_lock_);
+  FlatArcModel *flat;
+  bool exists;
+  flat_arc_models_.findKey(arc, flat, exists);
+  if (!exists) {
+    flat = new FlatArcModel;
+    if (!flat->init(cell, arc, pvt_)) {
+      // Cache the failure so the arc is not probed again.
+      delete flat;
+      flat = nullptr;
+    }
+    flat_arc_models_[arc] = flat;
+  }
+  return flat;
+}
+
+////////////////////////////////////////////////////////////////
+
+float
 Resizer::findTargetLoad(LibertyCell *cell,
 			Slew slews[])
 {
@@ -600,10 +1388,10 @@ Resizer::findTargetLoad(LibertyCell *cell,
     }
   }
   float target_load = (arc_count > 0) ? target_load_sum / arc_count : 0.0;
-  (*target_load_map_)[cell] = target_load;
   debugPrint2(debug_, "resizer", 3, "%s target_load = %.2e\n",
 	      cell->name(),
 	      target_load);
+  return target_load;
 }
 
 // Find the load capacitance that will cause the output slew
@@ -616,15 +1404,20 @@ Resizer::findTargetLoad(LibertyCell *cell,
 {
   GateTimingModel *model = dynamic_cast<GateTimingModel*>(arc->model());
   if (model) {
+    FlatArcModel *flat = flatArcModel(cell, arc);
     float cap_init = 1.0e-12;  // 1pF
     float cap_tol = cap_init * .001; // .1%
     float load_cap = cap_init;
     float cap_step = cap_init;
     while (cap_step > cap_tol) {
-      ArcDelay arc_delay;
       Slew arc_slew;
-      model->gateDelay(cell, pvt_, in_slew, load_cap, 0.0, false,
-		       arc_delay, arc_slew);
+      if (flat)
+	arc_slew = flat->slew(in_slew, load_cap);
+      else {
+	ArcDelay arc_delay;
+	model->gateDelay(cell, pvt_, in_slew, load_cap, 0.0, false,
+			 arc_delay, arc_slew);
+      }
       if (arc_slew > out_slew) {
 	load_cap -= cap_step;
 	cap_step /= 2.0;
@@ -655,8 +1448,19 @@ Resizer::findBufferTargetSlews(LibertyLibrarySeq *resize_libs)
   for (auto lib : *resize_libs) {
     Slew slews[TransRiseFall::index_count]{0.0};
     int counts[TransRiseFall::index_count]{0};
-    
-    findBufferTargetSlews(lib, slews, counts);
+
+    TargetLoadCacheEntry *entry = target_load_cache_.findKey(lib);
+    if (entry && entry->haveSlews()) {
+      for (auto tr : TransRiseFall::rangeIndex()) {
+	slews[tr] = entry->buffer_slews_[tr];
+	counts[tr] = entry->buffer_counts_[tr];
+      }
+    }
+    else {
+      findBufferTargetSlews(lib, slews, counts);
+      if (entry)
+	entry->setSlews(slews, counts);
+    }
     for (auto tr : TransRiseFall::rangeIndex()) {
       tgt_slews_[tr] += slews[tr];
       tgt_counts[tr] += counts[tr];
@@ -780,32 +1584,156 @@ Resizer::findClkNets()
   }
 }
 
+// Clock SDC edits invalidate the membership; the next ensureClkNets()
+// re-runs the BFS.
+void
+Resizer::clkNetsInvalid()
+{
+  clk_nets_.clear();
+  clk_nets__valid_ = false;
+}
+
 bool
 Resizer::isClock(Net *net)
 {
   return clk_nets_.hasKey(net);
 }
 
+void
+Resizer::inheritClkNet(Net *net,
+		       Net *new_net)
+{
+  if (clk_nets__valid_
+      && isClock(net))
+    clk_nets_.insert(new_net);
+}
+
+void
+Resizer::makeClock(const char *name,
+		   PinSet *pins,
+		   bool add_to_pins,
+		   float period,
+		   FloatSeq *waveform,
+		   char *comment)
+{
+  Sta::makeClock(name, pins, add_to_pins, period, waveform, comment);
+  clkNetsInvalid();
+}
+
+void
+Resizer::removeClock(Clock *clk)
+{
+  Sta::removeClock(clk);
+  clkNetsInvalid();
+}
+
 ////////////////////////////////////////////////////////////////
 
 void
 Resizer::makeNetParasitics()
 {
+  ResizerPhaseTimer timer(stats_, resizer_phase_parasitics);
+  NetSeq nets;
   NetIterator *net_iter = network_->netIterator(network_->topInstance());
   while (net_iter->hasNext()) {
     Net *net = net_iter->next();
     // Hands off the clock nets.
     if (!isClock(net))
-      makeNetParasitics(net);
+      nets.push_back(net);
   }
   delete net_iter;
+  if (thread_count_ > 1)
+    makeNetParasiticsParallel(nets);
+  else {
+    for (auto net : nets)
+      makeNetParasitics(net, steinerTree(net, false));
+  }
 }
 
+// Steiner tree construction for each net is independent, so it runs on
+// a worker pool. Only the insertions into parasitics_ have to be
+// serialized; each worker commits its nets a batch at a time so the
+// lock is not contended per net.
+void
+Resizer::makeNetParasiticsParallel(NetSeq &nets)
+{
+  LefDefNetwork *network = lefDefNetwork();
+  std::atomic<size_t> next_index(0);
+  std::mutex parasitics_lock;
+  const size_t batch_size = 128;
+  std::vector<std::thread> workers;
+  for (int i = 0; i < thread_count_; i++) {
+    workers.push_back(std::thread([&]() {
+      SteinerScratch scratch;
+      Vector<SteinerTree*> trees;
+      while (true) {
+	size_t from = next_index.fetch_add(batch_size);
+	if (from >= nets.size())
+	  break;
+	size_t to = min(from + batch_size, nets.size());
+	trees.clear();
+	for (size_t j = from; j < to; j++) {
+	  const Net *net = nets[j];
+	  SteinerTree *tree = steiner_tree_cache_.find(net);
+	  if (tree == nullptr) {
+	    tree = makeSteinerTree(net, false, network, scratch);
+	    stats_->incrCalls(resizer_phase_steiner);
+	    if (tree)
+	      steiner_tree_cache_.insert(net, tree);
+	  }
+	  trees.push_back(tree);
+	}
+	std::lock_guard<std::mutex> lock(parasitics_lock);
+	for (size_t j = from; j < to; j++)
+	  makeNetParasitics(nets[j], trees[j - from]);
+      }
+    }));
+  }
+  for (auto &worker : workers)
+    worker.join();
+}
+
+// Entry for incremental edits: remake the parasitics for one net and
+// invalidate just the timing cones that touch it.
 void
 Resizer::makeNetParasitics(const Net *net)
+{
+  makeNetParasitics(net, steinerTree(net, false));
+  timingInvalid(net);
+}
+
+void
+Resizer::timingInvalid(const Net *net)
+{
+  if (graph_) {
+    NetConnectedPinIterator *pin_iter = network_->connectedPinIterator(net);
+    while (pin_iter->hasNext()) {
+      Pin *pin = pin_iter->next();
+      Vertex *vertex, *bidirect_drvr_vertex;
+      graph_->pinVertices(pin, vertex, bidirect_drvr_vertex);
+      if (vertex)
+	timingInvalid(vertex);
+      if (bidirect_drvr_vertex)
+	timingInvalid(bidirect_drvr_vertex);
+    }
+    delete pin_iter;
+  }
+}
+
+void
+Resizer::timingInvalid(Vertex *vertex)
+{
+  graph_delay_calc_->delaysInvalidFrom(vertex);
+  search_->arrivalsInvalidFrom(vertex);
+  search_->requiredInvalid(vertex);
+  vertex_required_map_.erase(vertex);
+}
+
+void
+Resizer::makeNetParasitics(const Net *net,
+			   SteinerTree *tree)
 {
   LefDefNetwork *network = lefDefNetwork();
-  SteinerTree *tree = makeSteinerTree(net, false, network);
   if (tree && tree->isPlaced(network)) {
     debugPrint1(debug_, "resizer_parasitics", 1, "net %s\n",
 		sdc_network_->pathName(net));
@@ -845,10 +1773,86 @@ Resizer::makeNetParasitics(const Net *net)
 	}
       }
     }
-    delete tree;
   }
 }
 
+SteinerTree *
+Resizer::steinerTree(const Net *net,
+		     bool find_left_rights)
+{
+  LefDefNetwork *network = lefDefNetwork();
+  SteinerTree *tree = steiner_tree_cache_.find(net);
+  if (tree == nullptr) {
+    tree = makeSteinerTree(net, find_left_rights, network);
+    stats_->incrCalls(resizer_phase_steiner);
+    if (tree)
+      steiner_tree_cache_.insert(net, tree);
+  }
+  else if (find_left_rights
+	   && !tree->hasLeftRights())
+    tree->findLeftRights(network);
+  return tree;
+}
+
+void
+Resizer::connectPin(Instance *inst,
+		    Port *port,
+		    Net *net)
+{
+  Sta::connectPin(inst, port, net);
+  steiner_tree_cache_.erase(net);
+  requiredsInvalid(net);
+}
+
+void
+Resizer::connectPin(Instance *inst,
+		    LibertyPort *port,
+		    Net *net)
+{
+  Sta::connectPin(inst, port, net);
+  steiner_tree_cache_.erase(net);
+  requiredsInvalid(net);
+}
+
+void
+Resizer::disconnectPin(Pin *pin)
+{
+  Net *net = network_->net(pin);
+  if (net)
+    requiredsInvalid(net);
+  Sta::disconnectPin(pin);
+  if (net)
+    steiner_tree_cache_.erase(net);
+}
+
+void
+Resizer::deleteInstance(Instance *inst)
+{
+  // The required cache must not hold the instance's vertices; a
+  // vertex made later at a recycled address would hit them.
+  if (graph_) {
+    InstancePinIterator *pin_iter = network_->pinIterator(inst);
+    while (pin_iter->hasNext()) {
+      Pin *pin = pin_iter->next();
+      Vertex *vertex, *bidirect_drvr_vertex;
+      graph_->pinVertices(pin, vertex, bidirect_drvr_vertex);
+      if (vertex)
+	vertex_required_map_.erase(vertex);
+      if (bidirect_drvr_vertex)
+	vertex_required_map_.erase(bidirect_drvr_vertex);
+    }
+    delete pin_iter;
+  }
+  Sta::deleteInstance(inst);
+}
+
+void
+Resizer::deleteNet(Net *net)
+{
+  steiner_tree_cache_.erase(net);
+  Sta::deleteNet(net);
+}
+
 ParasiticNode *
 Resizer::findParasiticNode(SteinerTree *tree,
 			   Parasitic *parasitic,
@@ -870,16 +1874,85 @@ Resizer::findParasiticNode(SteinerTree *tree,
 void
 Resizer::rebufferNets(bool repair_max_cap,
 		      bool repair_max_slew,
-		      LibertyCell *buffer_cell)
+		      LibertyCellSeq *buffer_cells,
+		      int max_nets)
 {
-  if (repair_max_cap || repair_max_slew) {
-    rebuffer(repair_max_cap, repair_max_slew, buffer_cell);
+  if ((repair_max_cap || repair_max_slew)
+      && !buffer_cells->empty()) {
+    rebuffer(repair_max_cap, repair_max_slew, *buffer_cells, max_nets);
     report_->print("Inserted %d buffers in %d nets.\n",
 		   inserted_buffer_count_,
 		   rebuffer_net_count_);
   }
 }
 
+// Bump allocator for the rebuffer option DAG. Options are allocated
+// by the hundreds of thousands on high fanout nets and never freed
+// individually; the whole arena is reset after rebufferTopDown()
+// commits the winning option. Blocks are recycled across nets.
+class RebufferOptionArena
+{
+public:
+  RebufferOptionArena();
+  ~RebufferOptionArena();
+  void *allocate(size_t size);
+  // Bytes handed out since the last reset.
+  size_t bytesAllocated() const;
+  void reset();
+
+private:
+  static const size_t block_size = 64 * 1024;
+  Vector<char*> blocks_;
+  size_t block_index_;
+  size_t offset_;
+};
+
+RebufferOptionArena::RebufferOptionArena() :
+  block_index_(0),
+  offset_(0)
+{
+}
+
+RebufferOptionArena::~RebufferOptionArena()
+{
+  for (auto block : blocks_)
+    delete [] block;
+}
+
+void *
+RebufferOptionArena::allocate(size_t size)
+{
+  // Keep options naturally aligned.
+  size = (size + sizeof(void*) - 1) & ~(sizeof(void*) - 1);
+  if (blocks_.empty()) {
+    blocks_.push_back(new char[block_size]);
+    block_index_ = 0;
+    offset_ = 0;
+  }
+  else if (offset_ + size > block_size) {
+    block_index_++;
+    if (block_index_ == blocks_.size())
+      blocks_.push_back(new char[block_size]);
+    offset_ = 0;
+  }
+  void *result = blocks_[block_index_] + offset_;
+  offset_ += size;
+  return result;
+}
+
+size_t
+RebufferOptionArena::bytesAllocated() const
+{
+  return blocks_.empty() ? 0 : block_index_ * block_size + offset_;
+}
+
+void
+RebufferOptionArena::reset()
+{
+  block_index_ = 0;
+  offset_ = 0;
+}
+
 class RebufferOption
 {
 public:
@@ -890,16 +1963,21 @@ public:
 		 Required required,
 		 Pin *load_pin,
 		 DefPt location,
+		 // Buffer options only; the cell the option inserts.
+		 LibertyCell *buffer_cell,
 		 RebufferOption *ref,
 		 RebufferOption *ref2);
   ~RebufferOption();
+  void *operator new(size_t size,
+		     RebufferOptionArena *arena);
+  void operator delete(void *,
+		       RebufferOptionArena *);
   Type type() const { return type_; }
   float cap() const { return cap_; }
   Required required() const { return required_; }
-  Required bufferRequired(LibertyCell *buffer_cell,
-			  Resizer *resizer) const;
   DefPt location() const { return location_; }
   Pin *loadPin() const { return load_pin_; }
+  LibertyCell *bufferCell() const { return buffer_cell_; }
   RebufferOption *ref() const { return ref_; }
   RebufferOption *ref2() const { return ref2_; }
 
@@ -909,6 +1987,7 @@ private:
   Required required_;
   Pin *load_pin_;
   DefPt location_;
+  LibertyCell *buffer_cell_;
   RebufferOption *ref_;
   RebufferOption *ref2_;
 };
@@ -918,6 +1997,7 @@ RebufferOption::RebufferOption(Type type,
 			       Required required,
 			       Pin *load_pin,
 			       DefPt location,
+			       LibertyCell *buffer_cell,
 			       RebufferOption *ref,
 			       RebufferOption *ref2) :
   type_(type),
@@ -925,6 +2005,7 @@ RebufferOption::RebufferOption(Type type,
   required_(required),
   load_pin_(load_pin),
   location_(location),
+  buffer_cell_(buffer_cell),
   ref_(ref),
   ref2_(ref2)
 {
@@ -934,70 +2015,349 @@ RebufferOption::~RebufferOption()
 {
 }
 
-Required
-RebufferOption::bufferRequired(LibertyCell *buffer_cell,
-			       Resizer *resizer) const
+void *
+RebufferOption::operator new(size_t size,
+			     RebufferOptionArena *arena)
 {
-  return required_ - resizer->bufferDelay(buffer_cell, cap_);
+  return arena->allocate(size);
+}
+
+// Only called if a constructor throws; the arena reclaims the space
+// on reset.
+void
+RebufferOption::operator delete(void *,
+				RebufferOptionArena *)
+{
+}
+
+RebufferOptionArena *
+Resizer::rebufferOptionArena()
+{
+  if (rebuffer_option_arena_ == nullptr)
+    rebuffer_option_arena_ = new RebufferOptionArena;
+  return rebuffer_option_arena_;
 }
 
 ////////////////////////////////////////////////////////////////
 
+// Driver vertex with a max cap/slew violation and the relative
+// amount it exceeds its limit, used to visit only the violators.
+class DrvrViolation
+{
+public:
+  DrvrViolation(Vertex *vertex,
+		float severity);
+  Vertex *vertex() const { return vertex_; }
+  float severity() const { return severity_; }
+
+private:
+  Vertex *vertex_;
+  float severity_;
+};
+
+DrvrViolation::DrvrViolation(Vertex *vertex,
+			     float severity) :
+  vertex_(vertex),
+  severity_(severity)
+{
+}
+
 void
 Resizer::rebuffer(bool repair_max_cap,
 		  bool repair_max_slew,
-		  LibertyCell *buffer_cell)
+		  LibertyCellSeq &buffer_cells,
+		  int max_nets)
 {
+  ResizerPhaseTimer timer(stats_, resizer_phase_rebuffer);
   inserted_buffer_count_ = 0;
   rebuffer_net_count_ = 0;
+  // Required times cached by an earlier command do not see SDC
+  // changes made since; prefetchRequireds repopulates the cache.
+  vertex_required_map_.clear();
   findDelays();
-  // Rebuffer in reverse level order.
-  for (int i = level_drvr_verticies_.size() - 1; i >= 0; i--) {
-    Vertex *vertex = level_drvr_verticies_[i];
-    // Hands off the clock tree.
-    if (!search_->isClock(vertex)) {
-      Pin *drvr_pin = vertex->pin();
-      if ((repair_max_cap
-	   && hasMaxCapViolation(drvr_pin))
-	  || (repair_max_slew
-	      && hasMaxSlewViolation(drvr_pin))) {
-	rebuffer(drvr_pin, buffer_cell);
+  DrvrViolationSeq violations;
+  findViolatingDrvrs(repair_max_cap, repair_max_slew, violations);
+  if (thread_count_ > 1)
+    rebufferParallel(violations, buffer_cells, max_nets);
+  else {
+    for (auto &violation : violations) {
+      if (max_nets > 0
+	  && rebuffer_net_count_ >= max_nets)
+	break;
+      rebuffer(violation.vertex()->pin(), buffer_cells);
+      if (overMaxArea()) {
+	report_->warn("max utilization reached.\n");
+	break;
+      }
+    }
+  }
+}
+
+// Rebuffer the violating drivers with the bottom up searches spread
+// across the worker pool. Distinct nets have disjoint pin sets, so
+// the searches within a batch are independent; the network edits (the
+// top down commits) are serialized after the batch. Later nets in a
+// batch price their options against the requireds prefetched at the
+// start of the batch rather than after the preceding commits, the
+// same staleness the serial pass accepts within one net.
+void
+Resizer::rebufferParallel(DrvrViolationSeq &violations,
+			  LibertyCellSeq &buffer_cells,
+			  int max_nets)
+{
+  Vector<RebufferOptionArena*> arenas(thread_count_);
+  for (int i = 0; i < thread_count_; i++)
+    arenas[i] = new RebufferOptionArena;
+  const size_t batch_size = thread_count_ * 8;
+  size_t viol_index = 0;
+  bool done = false;
+  while (!done && viol_index < violations.size()) {
+    // Serial prep: guards, steiner trees and sink requireds.
+    Vector<const Pin*> drvr_pins;
+    Vector<Net*> nets;
+    Vector<LibertyPort*> drvr_ports;
+    Vector<SteinerTree*> trees;
+    Vector<int> fanouts;
+    while (drvr_pins.size() < batch_size
+	   && viol_index < violations.size()) {
+      const Pin *drvr_pin = violations[viol_index].vertex()->pin();
+      viol_index++;
+      Net *net;
+      LibertyPort *drvr_port;
+      SteinerTree *tree;
+      if (rebufferPreamble(drvr_pin, buffer_cells, net, drvr_port, tree)) {
+	prefetchRequireds(tree);
+	// Make sure the driver is constrained.
+	if (!fuzzyInf(pinRequired(drvr_pin))) {
+	  drvr_pins.push_back(drvr_pin);
+	  nets.push_back(net);
+	  drvr_ports.push_back(drvr_port);
+	  trees.push_back(tree);
+	  fanouts.push_back(tree->pinCount() - 1);
+	}
+      }
+    }
+    // Parallel searches, one private arena per worker.
+    size_t count = drvr_pins.size();
+    Vector<RebufferOption*> bests(count);
+    Vector<double> search_secs(count);
+    std::atomic<size_t> next_index(0);
+    std::vector<std::thread> workers;
+    for (int t = 0; t < thread_count_; t++) {
+      workers.push_back(std::thread([&, t]() {
+	while (true) {
+	  size_t j = next_index.fetch_add(1);
+	  if (j >= count)
+	    break;
+	  auto net_start = std::chrono::steady_clock::now();
+	  bests[j] = bestRebufferOption(drvr_pins[j], drvr_ports[j],
+					trees[j], buffer_cells,
+					arenas[t]);
+	  std::chrono::duration<double> net_elapsed =
+	    std::chrono::steady_clock::now() - net_start;
+	  search_secs[j] = net_elapsed.count();
+	}
+      }));
+    }
+    for (auto &worker : workers)
+      worker.join();
+    // Serial commits, worst violators first.
+    for (size_t j = 0; j < count && !done; j++) {
+      if (max_nets > 0
+	  && rebuffer_net_count_ >= max_nets)
+	done = true;
+      else {
+	if (bests[j]) {
+	  int before = inserted_buffer_count_;
+	  rebufferTopDown(bests[j], nets[j], 1);
+	  if (inserted_buffer_count_ != before)
+	    rebuffer_net_count_++;
+	}
+	stats_->recordRebufferNet(fanouts[j], search_secs[j]);
 	if (overMaxArea()) {
 	  report_->warn("max utilization reached.\n");
-	  break;
+	  done = true;
 	}
       }
     }
+    // The batch's options have been committed or discarded, so the
+    // option DAGs can be reclaimed.
+    for (auto arena : arenas) {
+      stats_->incrBytes(resizer_phase_rebuffer, arena->bytesAllocated());
+      arena->reset();
+    }
   }
+  for (auto arena : arenas)
+    delete arena;
 }
 
-bool
-Resizer::hasMaxCapViolation(const Pin *drvr_pin)
+// One sweep over the driver vertices checking limits so the rebuffer
+// loop walks only the violators, worst first.
+void
+Resizer::findViolatingDrvrs(bool repair_max_cap,
+			    bool repair_max_slew,
+			    // Return value.
+			    DrvrViolationSeq &violations)
+{
+  // Hands off the clock tree.
+  VertexSeq drvrs;
+  for (auto vertex : level_drvr_verticies_) {
+    if (!search_->isClock(vertex))
+      drvrs.push_back(vertex);
+  }
+  Vector<float> slew_limits;
+  Vector<bool> slew_limit_exists;
+  if (repair_max_slew)
+    findSlewLimits(drvrs, MinMax::max(), slew_limits, slew_limit_exists);
+  for (size_t i = 0; i < drvrs.size(); i++) {
+    Vertex *vertex = drvrs[i];
+    float severity = 0.0;
+    if (repair_max_cap)
+      severity = max(severity, capViolationSeverity(vertex->pin()));
+    if (repair_max_slew)
+      severity = max(severity, slewViolationSeverity(vertex,
+						     slew_limits[i],
+						     slew_limit_exists[i]));
+    if (severity > 0.0)
+      violations.push_back(DrvrViolation(vertex, severity));
+  }
+  sort(violations, [](const DrvrViolation &viol1,
+		      const DrvrViolation &viol2) {
+    return viol1.severity() > viol2.severity();
+  });
+}
+
+float
+Resizer::capViolationSeverity(const Pin *drvr_pin)
 {
   LibertyPort *port = network_->libertyPort(drvr_pin);
   if (port) {
-    float load_cap = graph_delay_calc_->loadCap(drvr_pin, dcalc_ap_);
     float cap_limit;
     bool exists;
     port->capacitanceLimit(MinMax::max(), cap_limit, exists);
-    return exists && load_cap > cap_limit;
+    if (exists
+	&& cap_limit > 0.0) {
+      float load_cap = graph_delay_calc_->loadCap(drvr_pin, dcalc_ap_);
+      if (load_cap > cap_limit)
+	return (load_cap - cap_limit) / cap_limit;
+    }
   }
-  return false;
+  return 0.0;
 }
 
-bool
-Resizer::hasMaxSlewViolation(const Pin *drvr_pin)
+// The limit comes pre-resolved from findSlewLimits so the slew scan
+// is a tight loop over the graph slews.
+float
+Resizer::slewViolationSeverity(Vertex *vertex,
+			       float limit,
+			       bool limit_exists)
+{
+  if (limit_exists
+      && limit > 0.0) {
+    float severity = 0.0;
+    for (auto tr : TransRiseFall::range()) {
+      Slew slew = graph_->slew(vertex, tr, dcalc_ap_->index());
+      if (slew > limit)
+	severity = max(severity,
+		       static_cast<float>((slew - limit) / limit));
+    }
+    return severity;
+  }
+  return 0.0;
+}
+
+// Liberty port limit folded with the design limit, resolved once per
+// distinct port during a sweep.
+class PortSlewLimit
 {
-  Vertex *vertex = graph_->pinDrvrVertex(drvr_pin);
-  float limit;
-  bool exists;
-  slewLimit(drvr_pin, MinMax::max(), limit, exists);
-  for (auto tr : TransRiseFall::range()) {
-    Slew slew = graph_->slew(vertex, tr, dcalc_ap_->index());
-    if (slew > limit)
-      return true;
+public:
+  PortSlewLimit();
+  PortSlewLimit(float limit,
+		bool exists);
+  float limit() const { return limit_; }
+  bool exists() const { return exists_; }
+
+private:
+  float limit_;
+  bool exists_;
+};
+
+PortSlewLimit::PortSlewLimit() :
+  limit_(0.0),
+  exists_(false)
+{
+}
+
+PortSlewLimit::PortSlewLimit(float limit,
+			     bool exists) :
+  limit_(limit),
+  exists_(exists)
+{
+}
+
+typedef UnorderedMap<LibertyPort*, PortSlewLimit> PortSlewLimitMap;
+
+void
+Resizer::findSlewLimits(const VertexSeq &drvrs,
+			const MinMax *min_max,
+			// Return values.
+			Vector<float> &limits,
+			Vector<bool> &limit_exists)
+{
+  limits.resize(drvrs.size());
+  limit_exists.resize(drvrs.size());
+  // Resolve the top cell ("design") limit once for the sweep.
+  Cell *top_cell = network_->cell(network_->topInstance());
+  float top_limit;
+  bool top_limit_exists;
+  sdc_->slewLimit(top_cell, min_max,
+		  top_limit, top_limit_exists);
+  PortSlewLimitMap port_limits;
+  for (size_t i = 0; i < drvrs.size(); i++) {
+    Pin *pin = drvrs[i]->pin();
+    float limit = top_limit;
+    bool exists = top_limit_exists;
+    if (network_->isTopLevelPort(pin))
+      pinSlewLimit(pin, min_max, top_limit, top_limit_exists,
+		   limit, exists);
+    else {
+      LibertyPort *port = network_->libertyPort(pin);
+      if (port) {
+	PortSlewLimit port_limit;
+	bool cached;
+	port_limits.findKey(port, port_limit, cached);
+	if (!cached) {
+	  float port_limit1;
+	  bool port_limit_exists1;
+	  port->slewLimit(min_max, port_limit1, port_limit_exists1);
+	  // Use the tightest limit.
+	  if (port_limit_exists1
+	      && (!exists
+		  || min_max->compare(limit, port_limit1)))
+	    port_limit = PortSlewLimit(port_limit1, true);
+	  else
+	    port_limit = PortSlewLimit(limit, exists);
+	  port_limits[port] = port_limit;
+	}
+	limit = port_limit.limit();
+	exists = port_limit.exists();
+      }
+      // Pin level SDC limits are rare; fold them last.
+      float pin_limit;
+      bool pin_limit_exists;
+      sdc_->slewLimit(pin, min_max,
+		      pin_limit, pin_limit_exists);
+      // Use the tightest limit.
+      if (pin_limit_exists
+	  && (!exists
+	      || min_max->compare(limit, pin_limit))) {
+	limit = pin_limit;
+	exists = true;
+      }
+    }
+    limits[i] = limit;
+    limit_exists[i] = exists;
   }
-  return false;
 }
 
 void
@@ -1006,15 +2366,26 @@ Resizer::slewLimit(const Pin *pin,
 		   // Return values.
 		   float &limit,
 		   bool &exists) const
-			
+
 {
-  exists = false;
   Cell *top_cell = network_->cell(network_->topInstance());
   float top_limit;
   bool top_limit_exists;
   sdc_->slewLimit(top_cell, min_max,
 		  top_limit, top_limit_exists);
+  pinSlewLimit(pin, min_max, top_limit, top_limit_exists,
+	       limit, exists);
+}
 
+void
+Resizer::pinSlewLimit(const Pin *pin,
+		      const MinMax *min_max,
+		      float top_limit,
+		      bool top_limit_exists,
+		      // Return values.
+		      float &limit,
+		      bool &exists) const
+{
   // Default to top ("design") limit.
   exists = top_limit_exists;
   limit = top_limit;
@@ -1066,26 +2437,32 @@ Resizer::rebuffer(Net *net,
 {
   inserted_buffer_count_ = 0;
   rebuffer_net_count_ = 0;
+  LibertyCellSeq buffer_cells;
+  buffer_cells.push_back(buffer_cell);
   PinSet *drvrs = network_->drivers(net);
   PinSet::Iterator drvr_iter(drvrs);
   if (drvr_iter.hasNext()) {
     Pin *drvr = drvr_iter.next();
-    rebuffer(drvr, buffer_cell);
+    rebuffer(drvr, buffer_cells);
   }
   report_->print("Inserted %d buffers.\n", inserted_buffer_count_);
 }
 
-void
-Resizer::rebuffer(const Pin *drvr_pin,
-		  LibertyCell *buffer_cell)
+// Guards and cached steiner tree shared by the serial and parallel
+// rebuffer passes.
+bool
+Resizer::rebufferPreamble(const Pin *drvr_pin,
+			  LibertyCellSeq &buffer_cells,
+			  // Return values.
+			  Net *&net,
+			  LibertyPort *&drvr_port,
+			  SteinerTree *&tree)
 {
-  Net *net;
-  LibertyPort *drvr_port;
   if (network_->isTopLevelPort(drvr_pin)) {
     net = network_->net(network_->term(drvr_pin));
     // Should use sdc external driver here.
     LibertyPort *input;
-    buffer_cell->bufferPorts(input, drvr_port);
+    buffer_cells[0]->bufferPorts(input, drvr_port);
   }
   else {
     net = network_->net(drvr_pin);
@@ -1095,34 +2472,72 @@ Resizer::rebuffer(const Pin *drvr_pin,
       // Verilog connects by net name, so there is no way to distinguish the
       // net from the port.
       && !hasTopLevelOutputPort(net)) {
-    LefDefNetwork *network = lefDefNetwork();
-    SteinerTree *tree = makeSteinerTree(net, true, network);
-    if (tree) {
-      SteinerPt drvr_pt = tree->drvrPt(network_);
-      Required drvr_req = pinRequired(drvr_pin);
-      // Make sure the driver is constrained.
-      if (!fuzzyInf(drvr_req)) {
-	debugPrint1(debug_, "rebuffer", 2, "driver %s\n",
-		    sdc_network_->pathName(drvr_pin));
-	RebufferOptionSeq Z = rebufferBottomUp(tree, tree->left(drvr_pt),
-					       drvr_pt,
-					       1, buffer_cell);
-	Required Tbest = -INF;
-	RebufferOption *best = nullptr;
-	for (auto p : Z) {
-	  Required Tb = p->required() - gateDelay(drvr_port, p->cap());
-	  if (fuzzyGreater(Tb, Tbest)) {
-	    Tbest = Tb;
-	    best = p;
-	  }
-	}
-	if (best) {
-	  int before = inserted_buffer_count_;
-	  rebufferTopDown(best, net, 1, buffer_cell);
-	  if (inserted_buffer_count_ != before)
-	    rebuffer_net_count_++;
-	}
+    tree = steinerTree(net, true);
+    return tree != nullptr;
+  }
+  return false;
+}
+
+// Bottom up option search and driver argmax. Read-only against the
+// network and timing caches once the sink requireds are prefetched,
+// so worker threads can run it concurrently on distinct nets.
+RebufferOption *
+Resizer::bestRebufferOption(const Pin *drvr_pin,
+			    LibertyPort *drvr_port,
+			    SteinerTree *tree,
+			    LibertyCellSeq &buffer_cells,
+			    RebufferOptionArena *arena)
+{
+  debugPrint1(debug_, "rebuffer", 2, "driver %s\n",
+	      sdc_network_->pathName(drvr_pin));
+  SteinerPt drvr_pt = tree->drvrPt(network_);
+  RebufferOptionSeq Z = rebufferBottomUp(tree, tree->left(drvr_pt),
+					 drvr_pt,
+					 1, buffer_cells, arena);
+  Required Tbest = -INF;
+  RebufferOption *best = nullptr;
+  for (auto p : Z) {
+    Required Tb = p->required() - gateDelay(drvr_port, p->cap());
+    if (fuzzyGreater(Tb, Tbest)) {
+      Tbest = Tb;
+      best = p;
+    }
+  }
+  return best;
+}
+
+void
+Resizer::rebuffer(const Pin *drvr_pin,
+		  LibertyCellSeq &buffer_cells)
+{
+  Net *net;
+  LibertyPort *drvr_port;
+  SteinerTree *tree;
+  if (rebufferPreamble(drvr_pin, buffer_cells, net, drvr_port, tree)) {
+    prefetchRequireds(tree);
+    Required drvr_req = pinRequired(drvr_pin);
+    // Make sure the driver is constrained.
+    if (!fuzzyInf(drvr_req)) {
+      auto net_start = std::chrono::steady_clock::now();
+      // Committing the winning option edits the net, which evicts
+      // tree from the steiner cache.
+      int fanout = tree->pinCount() - 1;
+      RebufferOptionArena *arena = rebufferOptionArena();
+      RebufferOption *best = bestRebufferOption(drvr_pin, drvr_port, tree,
+						buffer_cells, arena);
+      if (best) {
+	int before = inserted_buffer_count_;
+	rebufferTopDown(best, net, 1);
+	if (inserted_buffer_count_ != before)
+	  rebuffer_net_count_++;
       }
+      // The winning option has been committed to the network, so
+      // the whole option DAG for this net can be reclaimed.
+      stats_->incrBytes(resizer_phase_rebuffer, arena->bytesAllocated());
+      arena->reset();
+      std::chrono::duration<double> net_elapsed =
+	std::chrono::steady_clock::now() - net_start;
+      stats_->recordRebufferNet(fanout, net_elapsed.count());
     }
   }
 }
@@ -1143,32 +2558,41 @@ Resizer::hasTopLevelOutputPort(Net *net)
   return false;
 }
 
-class RebufferOptionBufferReqGreater
-{
-public:
-  RebufferOptionBufferReqGreater(LibertyCell *buffer_cell,
-				 Resizer *resizer);
-  bool operator()(RebufferOption *option1,
-		  RebufferOption *option2);
-
-protected:
-  LibertyCell *buffer_cell_;
-  Resizer *resizer_;
-};
-
-RebufferOptionBufferReqGreater::RebufferOptionBufferReqGreater(LibertyCell *buffer_cell,
-							       Resizer *resizer) :
-  buffer_cell_(buffer_cell),
-  resizer_(resizer)
+void
+Resizer::setRebufferMaxOptions(int max_options)
 {
+  rebuffer_max_options_ = max_options;
 }
- 
-bool
-RebufferOptionBufferReqGreater::operator()(RebufferOption *option1,
-					   RebufferOption *option2)
-{
-  return fuzzyGreater(option1->bufferRequired(buffer_cell_, resizer_),
-		      option2->bufferRequired(buffer_cell_, resizer_));
+
+// Reduce Z to its Pareto frontier: sorted by cap with strictly
+// increasing required, so more cap is only carried when it buys more
+// required time. rebuffer_max_options_ bounds the frontier width.
+void
+Resizer::pruneRebufferOptions(RebufferOptionSeq &Z)
+{
+  sort(Z, [](const RebufferOption *option1,
+	     const RebufferOption *option2) {
+    return option1->cap() < option2->cap()
+      || (option1->cap() == option2->cap()
+	  && option1->required() > option2->required());
+  });
+  size_t si = 0;
+  for (size_t i = 0; i < Z.size(); i++) {
+    RebufferOption *p = Z[i];
+    if (si == 0
+	|| fuzzyGreater(p->required(), Z[si - 1]->required()))
+      Z[si++] = p;
+  }
+  Z.resize(si);
+  size_t max_options = rebuffer_max_options_;
+  if (max_options > 1
+      && Z.size() > max_options) {
+    // Sample the frontier evenly to preserve its cap range.
+    RebufferOptionSeq sampled;
+    for (size_t i = 0; i < max_options; i++)
+      sampled.push_back(Z[i * (Z.size() - 1) / (max_options - 1)]);
+    Z = sampled;
+  }
 }
 
 // The routing tree is represented a binary tree with the sinks being the leaves
@@ -1179,18 +2603,20 @@ Resizer::rebufferBottomUp(SteinerTree *tree,
 			  SteinerPt k,
 			  SteinerPt prev,
 			  int level,
-			  LibertyCell *buffer_cell)
+			  LibertyCellSeq &buffer_cells,
+			  RebufferOptionArena *arena)
 {
   if (k != SteinerTree::null_pt) {
     Pin *pin = tree->pin(k);
     if (pin && network_->isLoad(pin)) {
       // Load capacitance and required time.
-      RebufferOption *z = new RebufferOption(RebufferOption::Type::sink,
-					     pinCapacitance(pin),
-					     pinRequired(pin),
-					     pin,
-					     tree->location(k),
-					     nullptr, nullptr);
+      RebufferOption *z = new (arena) RebufferOption(RebufferOption::Type::sink,
+						     pinCapacitance(pin),
+						     pinRequired(pin),
+						     pin,
+						     tree->location(k),
+						     nullptr,
+						     nullptr, nullptr);
       // %*s format indents level spaces.
       debugPrint5(debug_, "rebuffer", 3, "%*sload %s cap %s req %s\n",
 		  level, "",
@@ -1199,55 +2625,45 @@ Resizer::rebufferBottomUp(SteinerTree *tree,
 		  delayAsString(z->required(), this));
       RebufferOptionSeq Z;
       Z.push_back(z);
-      return addWireAndBuffer(Z, tree, k, prev, level, buffer_cell);
+      return addWireAndBuffer(Z, tree, k, prev, level, buffer_cells, arena);
     }
     else if (pin == nullptr) {
       // Steiner pt.
       RebufferOptionSeq Zl = rebufferBottomUp(tree, tree->left(k), k,
-					      level + 1, buffer_cell);
+					      level + 1, buffer_cells, arena);
       RebufferOptionSeq Zr = rebufferBottomUp(tree, tree->right(k), k,
-					      level + 1, buffer_cell);
+					      level + 1, buffer_cells, arena);
       RebufferOptionSeq Z;
-      // Combine the options from both branches.
-      for (auto p : Zl) {
-	for (auto q : Zr) {
-	  RebufferOption *junc = new RebufferOption(RebufferOption::Type::junction,
-						    p->cap() + q->cap(),
-						    min(p->required(),
-							q->required()),
-						    nullptr,
-						    tree->location(k),
-						    p, q);
-	  Z.push_back(junc);
-	}
-      }
-      // Prune the options. This is fanout^2.
-      // Presort options to hit better options sooner.
-      sort(Z, RebufferOptionBufferReqGreater(buffer_cell, this));
-      int si = 0;
-      for (size_t pi = 0; pi < Z.size(); pi++) {
-	auto p = Z[pi];
-	if (p) {
-	  float Lp = p->cap();
-	  // Remove options by shifting down with index si.
-	  si = pi + 1;
-	  // Because the options are sorted we don't have to look
-	  // beyond the first option.
-	  for (size_t qi = pi + 1; qi < Z.size(); qi++) {
-	    auto q = Z[qi];
-	    if (q) {
-	      float Lq = q->cap();
-	      // We know Tq <= Tp from the sort so we don't need to check req.
-	      // If q is the same or worse than p, remove solution q.
-	      if (fuzzyLess(Lq, Lp))
-		// Copy survivor down.
-		Z[si++] = q;
-	    }
-	  }
-	  Z.resize(si);
+      // Combine the options from both branches with a linear skyline
+      // merge. Both frontiers are sorted by cap with increasing
+      // required, so only pairs where one branch's required binds the
+      // junction can be Pareto optimal; advance the binding branch to
+      // trade more cap for more required time.
+      size_t il = 0;
+      size_t ir = 0;
+      while (il < Zl.size() && ir < Zr.size()) {
+	RebufferOption *p = Zl[il];
+	RebufferOption *q = Zr[ir];
+	RebufferOption *junc = new (arena) RebufferOption(RebufferOption::Type::junction,
+							  p->cap() + q->cap(),
+							  min(p->required(),
+							      q->required()),
+							  nullptr,
+							  tree->location(k),
+							  nullptr,
+							  p, q);
+	Z.push_back(junc);
+	if (fuzzyLess(p->required(), q->required()))
+	  il++;
+	else if (fuzzyLess(q->required(), p->required()))
+	  ir++;
+	else {
+	  il++;
+	  ir++;
 	}
       }
-      return addWireAndBuffer(Z, tree, k, prev, level, buffer_cell);
+      pruneRebufferOptions(Z);
+      return addWireAndBuffer(Z, tree, k, prev, level, buffer_cells, arena);
     }
   }
   return RebufferOptionSeq();
@@ -1259,12 +2675,11 @@ Resizer::addWireAndBuffer(RebufferOptionSeq Z,
 			  SteinerPt k,
 			  SteinerPt prev,
 			  int level,
-			  LibertyCell *buffer_cell)
+			  LibertyCellSeq &buffer_cells,
+			  RebufferOptionArena *arena)
 {
   LefDefNetwork *network = lefDefNetwork();
   RebufferOptionSeq Z1;
-  Required best = -INF;
-  RebufferOption *best_ref = nullptr;
   DefPt k_loc = tree->location(k);
   DefPt prev_loc = tree->location(prev);
   DefDbu wire_length_dbu = abs(k_loc.x() - prev_loc.x())
@@ -1273,15 +2688,17 @@ Resizer::addWireAndBuffer(RebufferOptionSeq Z,
   float wire_cap = wire_length * wire_cap_;
   float wire_res = wire_length * wire_res_;
   float wire_delay = wire_res * wire_cap;
+  Vector<float> load_caps;
   for (auto p : Z) {
-    RebufferOption *z = new RebufferOption(RebufferOption::Type::wire,
-					   // account for wire load
-					   p->cap() + wire_cap,
-					   // account for wire delay
-					   p->required() - wire_delay,
-					   nullptr,
-					   prev_loc,
-					   p, nullptr);
+    RebufferOption *z = new (arena) RebufferOption(RebufferOption::Type::wire,
+						   // account for wire load
+						   p->cap() + wire_cap,
+						   // account for wire delay
+						   p->required() - wire_delay,
+						   nullptr,
+						   prev_loc,
+						   nullptr,
+						   p, nullptr);
     debugPrint7(debug_, "rebuffer", 3, "%*swire %s -> %s wl %d cap %s req %s\n",
 		level, "",
 		tree->name(prev, sdc_network_),
@@ -1290,31 +2707,50 @@ Resizer::addWireAndBuffer(RebufferOptionSeq Z,
 		units_->capacitanceUnit()->asString(z->cap()),
 		delayAsString(z->required(), this));
     Z1.push_back(z);
-    // We could add options of different buffer drive strengths here
-    // Which would have different delay Dbuf and input cap Lbuf
-    // for simplicity we only consider one size of buffer.
-    Required rt = z->bufferRequired(buffer_cell, this);
-    if (fuzzyGreater(rt, best)) {
-      best = rt;
-      best_ref = p;
-    }
+    load_caps.push_back(z->cap());
   }
-  if (best_ref) {
-    RebufferOption *z = new RebufferOption(RebufferOption::Type::buffer,
-					   bufferInputCapacitance(buffer_cell),
-					   best,
-					   nullptr,
-					   // Locate buffer at opposite end of wire.
-					   prev_loc,
-					   best_ref, nullptr);
-    debugPrint7(debug_, "rebuffer", 3, "%*sbuffer %s cap %s req %s -> cap %s req %s\n",
-		level, "",
-		tree->name(prev, sdc_network_),
-		units_->capacitanceUnit()->asString(best_ref->cap()),
-		delayAsString(best_ref->required(), this),
-		units_->capacitanceUnit()->asString(z->cap()),
-		delayAsString(z->required(), this));
-    Z1.push_back(z);
+  if (!Z1.empty()) {
+    // All drive strengths compete; each buffer cell contributes its
+    // best option, priced with one batched delay evaluation over the
+    // wire option caps.
+    size_t wire_count = Z1.size();
+    Vector<float> buffer_delays(wire_count);
+    bool appended = false;
+    for (auto buffer_cell : buffer_cells) {
+      Required best = -INF;
+      RebufferOption *best_ref = nullptr;
+      bufferDelays(buffer_cell, &load_caps[0], wire_count,
+		   &buffer_delays[0]);
+      for (size_t i = 0; i < wire_count; i++) {
+	Required rt = Z1[i]->required() - buffer_delays[i];
+	if (fuzzyGreater(rt, best)) {
+	  best = rt;
+	  best_ref = Z1[i]->ref();
+	}
+      }
+      if (best_ref) {
+	RebufferOption *z = new (arena) RebufferOption(RebufferOption::Type::buffer,
+						       bufferInputCapacitance(buffer_cell),
+						       best,
+						       nullptr,
+						       // Locate buffer at opposite end of wire.
+						       prev_loc,
+						       buffer_cell,
+						       best_ref, nullptr);
+	debugPrint7(debug_, "rebuffer", 3, "%*sbuffer %s cap %s req %s -> cap %s req %s\n",
+		    level, "",
+		    tree->name(prev, sdc_network_),
+		    units_->capacitanceUnit()->asString(best_ref->cap()),
+		    delayAsString(best_ref->required(), this),
+		    units_->capacitanceUnit()->asString(z->cap()),
+		    delayAsString(z->required(), this));
+	Z1.push_back(z);
+	appended = true;
+      }
+    }
+    // Restore the frontier invariant the buffer options may break.
+    if (appended)
+      pruneRebufferOptions(Z1);
   }
   return Z1;
 }
@@ -1323,22 +2759,21 @@ Resizer::addWireAndBuffer(RebufferOptionSeq Z,
 void
 Resizer::rebufferTopDown(RebufferOption *choice,
 			 Net *net,
-			 int level,
-			 LibertyCell *buffer_cell)
+			 int level)
 {
   LefDefNetwork *network = lefDefNetwork();
   switch(choice->type()) {
   case RebufferOption::Type::buffer: {
     Instance *parent = network->topInstance();
+    LibertyCell *buffer_cell = choice->bufferCell();
     string net2_name = makeUniqueNetName();
     string buffer_name = makeUniqueBufferName();
     Net *net2 = network->makeNet(net2_name.c_str(), parent);
+    inheritClkNet(net, net2);
     Instance *buffer = network->makeInstance(buffer_cell,
 					     buffer_name.c_str(),
 					     parent);
     inserted_buffer_count_++;
-    design_area_ += network->area(buffer);
-    level_drvr_verticies_valid_ = false;
     LibertyPort *input, *output;
     buffer_cell->bufferPorts(input, output);
     debugPrint5(debug_, "rebuffer", 3, "%*sinsert %s -> %s -> %s\n",
@@ -1348,20 +2783,26 @@ Resizer::rebufferTopDown(RebufferOption *choice,
 		net2_name.c_str());
     connectPin(buffer, input, net);
     connectPin(buffer, output, net2);
+    Pin *buffer_out_pin = network->findPin(buffer, output->name());
+    if (buffer_out_pin) {
+      Vertex *drvr_vertex = graph_->pinDrvrVertex(buffer_out_pin);
+      if (drvr_vertex)
+	insertLevelDrvrVertex(drvr_vertex);
+    }
     network->setLocation(buffer, choice->location());
-    rebufferTopDown(choice->ref(), net2, level + 1, buffer_cell);
+    rebufferTopDown(choice->ref(), net2, level + 1);
     makeNetParasitics(net);
     makeNetParasitics(net2);
     break;
   }
   case RebufferOption::Type::wire:
     debugPrint2(debug_, "rebuffer", 3, "%*swire\n", level, "");
-    rebufferTopDown(choice->ref(), net, level + 1, buffer_cell);
+    rebufferTopDown(choice->ref(), net, level + 1);
     break;
   case RebufferOption::Type::junction: {
     debugPrint2(debug_, "rebuffer", 3, "%*sjunction\n", level, "");
-    rebufferTopDown(choice->ref(), net, level + 1, buffer_cell);
-    rebufferTopDown(choice->ref2(), net, level + 1, buffer_cell);
+    rebufferTopDown(choice->ref(), net, level + 1);
+    rebufferTopDown(choice->ref2(), net, level + 1);
     break;
   }
   case RebufferOption::Type::sink: {
@@ -1374,8 +2815,9 @@ Resizer::rebufferTopDown(RebufferOption *choice,
 		  level, "",
 		  sdc_network_->pathName(load_pin),
 		  sdc_network_->pathName(net));
-      disconnectPin(load_pin);
-      connectPin(load_inst, load_port, net);
+      PinSeq load_pins;
+      load_pins.push_back(load_pin);
+      movePins(load_net, net, load_pins);
     }
     break;
   }
@@ -1385,22 +2827,13 @@ Resizer::rebufferTopDown(RebufferOption *choice,
 string
 Resizer::makeUniqueNetName()
 {
-  string node_name;
-  Instance *top_inst = network_->topInstance();
-  do 
-    stringPrint(node_name, "net%d", unique_net_index_++);
-  while (network_->findNet(top_inst, node_name.c_str()));
-  return node_name;
+  return lefDefNetwork()->makeUniqueNetName();
 }
 
 string
 Resizer::makeUniqueBufferName()
 {
-  string buffer_name;
-  do 
-    stringPrint(buffer_name, "buffer%d", unique_buffer_index_++);
-  while (network_->findInstance(buffer_name.c_str()));
-  return buffer_name;
+  return lefDefNetwork()->makeUniqueBufferName();
 }
 
 float
@@ -1436,13 +2869,20 @@ Resizer::pinRequired(const Pin *pin)
   return vertexRequired(vertex, min_max_);
 }
 
+// Cached by vertex; all callers query min_max_ so the cache does not
+// need a min/max dimension.
 Required
 Resizer::vertexRequired(Vertex *vertex,
 			const MinMax *min_max)
 {
+  Required required;
+  bool exists;
+  vertex_required_map_.findKey(vertex, required, exists);
+  if (exists)
+    return required;
   findRequired(vertex);
   const MinMax *req_min_max = min_max->opposite();
-  Required required = req_min_max->initValue();
+  required = req_min_max->initValue();
   VertexPathIterator path_iter(vertex, this);
   while (path_iter.hasNext()) {
     const Path *path = path_iter.next();
@@ -1452,9 +2892,52 @@ Resizer::vertexRequired(Vertex *vertex,
 	required = path_required;
     }
   }
+  vertex_required_map_[vertex] = required;
   return required;
 }
 
+// Compute requireds for all of the driver's sinks in one levelized
+// search sweep before the bottom-up merge re-queries them per option.
+void
+Resizer::prefetchRequireds(SteinerTree *tree)
+{
+  Vertex *min_vertex = nullptr;
+  for (auto pin : tree->pins()) {
+    if (network_->isLoad(pin)) {
+      Vertex *vertex = graph_->pinLoadVertex(pin);
+      if (vertex
+	  && (min_vertex == nullptr
+	      || vertex->level() < min_vertex->level()))
+	min_vertex = vertex;
+    }
+  }
+  // One search pass down to the lowest sink level covers every sink.
+  if (min_vertex)
+    findRequired(min_vertex);
+  for (auto pin : tree->pins()) {
+    if (network_->isLoad(pin))
+      pinRequired(pin);
+  }
+}
+
+void
+Resizer::requiredsInvalid(const Net *net)
+{
+  if (graph_) {
+    NetConnectedPinIterator *pin_iter = network_->connectedPinIterator(net);
+    while (pin_iter->hasNext()) {
+      Pin *pin = pin_iter->next();
+      Vertex *vertex, *bidirect_drvr_vertex;
+      graph_->pinVertices(pin, vertex, bidirect_drvr_vertex);
+      if (vertex)
+	vertex_required_map_.erase(vertex);
+      if (bidirect_drvr_vertex)
+	vertex_required_map_.erase(bidirect_drvr_vertex);
+    }
+    delete pin_iter;
+  }
+}
+
 float
 Resizer::bufferDelay(LibertyCell *buffer_cell,
 		     float load_cap)
@@ -1464,13 +2947,39 @@ Resizer::bufferDelay(LibertyCell *buffer_cell,
   return gateDelay(output, load_cap);
 }
 
+void
+Resizer::bufferDelays(LibertyCell *buffer_cell,
+		      const float *load_caps,
+		      int count,
+		      // Return values.
+		      float *delays)
+{
+  LibertyPort *input, *output;
+  buffer_cell->bufferPorts(input, output);
+  gateDelays(output, load_caps, count, delays);
+}
+
 float
 Resizer::gateDelay(LibertyPort *out_port,
 		   float load_cap)
+{
+  float delay;
+  gateDelays(out_port, &load_cap, 1, &delay);
+  return delay;
+}
+
+// Max rise/fall delays for each load cap. The arc walk and flat
+// table setup are paid once for the whole batch.
+void
+Resizer::gateDelays(LibertyPort *out_port,
+		    const float *load_caps,
+		    int count,
+		    // Return values.
+		    float *delays)
 {
   LibertyCell *cell = out_port->libertyCell();
-  // Max rise/fall delays.
-  ArcDelay max_delay = -INF;
+  for (int i = 0; i < count; i++)
+    delays[i] = -INF;
   LibertyCellTimingArcSetIterator set_iter(cell);
   while (set_iter.hasNext()) {
     TimingArcSet *arc_set = set_iter.next();
@@ -1480,27 +2989,35 @@ Resizer::gateDelay(LibertyPort *out_port,
 	TimingArc *arc = arc_iter.next();
 	TransRiseFall *in_tr = arc->fromTrans()->asRiseFall();
 	float in_slew = tgt_slews_[in_tr->index()];
-	ArcDelay gate_delay;
-	Slew drvr_slew;
-	arc_delay_calc_->gateDelay(cell, arc, in_slew, load_cap,
-				   nullptr, 0.0, pvt_, dcalc_ap_,
-				   gate_delay,
-				   drvr_slew);
-	max_delay = max(max_delay, gate_delay);
+	FlatArcModel *flat = flatArcModel(cell, arc);
+	if (flat) {
+	  for (int i = 0; i < count; i++)
+	    delays[i] = max(delays[i], flat->delay(in_slew, load_caps[i]));
+	}
+	else {
+	  // The flat models are thread safe; the fallback delay
+	  // calculator is not.
+	  std::lock_guard<std::mutex> lock(dcalc_lock_);
+	  for (int i = 0; i < count; i++) {
+	    ArcDelay gate_delay;
+	    Slew drvr_slew;
+	    arc_delay_calc_->gateDelay(cell, arc, in_slew, load_caps[i],
+				       nullptr, 0.0, pvt_, dcalc_ap_,
+				       gate_delay,
+				       drvr_slew);
+	    delays[i] = max(delays[i], static_cast<float>(gate_delay));
+	  }
+	}
       }
     }
   }
-  return max_delay;
 }
 
+// The network maintains the design area incrementally across edits.
 double
 Resizer::designArea()
 {
-  if (design_area_ == 0.0) {
-    LefDefNetwork *network = lefDefNetwork();
-    design_area_ = network->designArea();
-  }
-  return design_area_;
+  return lefDefNetwork()->designArea();
 }
 
 }
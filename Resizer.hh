@@ -17,32 +17,55 @@
 #ifndef RESIZER_RESIZER_H
 #define RESIZER_RESIZER_H
 
+#include <mutex>
+
 #include "Sta.hh"
 #include "SteinerTree.hh"
 
 namespace sta {
 
+class DrvrViolation;
+class FlatArcModel;
 class LefDefNetwork;
 class RebufferOption;
+class RebufferOptionArena;
+class ResizerStats;
+class TargetLoadCacheEntry;
+class TargetLoadCell;
 
+typedef Vector<DrvrViolation> DrvrViolationSeq;
+typedef Map<TimingArc*, FlatArcModel*> FlatArcModelMap;
+typedef Map<LibertyLibrary*, TargetLoadCacheEntry*> TargetLoadCacheMap;
 typedef Map<LibertyCell*, float> CellTargetLoadMap;
+typedef Vector<TargetLoadCell> TargetLoadCellSeq;
+typedef Map<LibertyCell*, TargetLoadCellSeq*> CellTargetLoadCellsMap;
 typedef Vector<RebufferOption*> RebufferOptionSeq;
+typedef Map<Vertex*, Required> VertexRequiredMap;
 
 class Resizer : public Sta
 {
 public:
   Resizer();
+  virtual ~Resizer();
   LefDefNetwork *lefDefNetwork();
   const LefDefNetwork *lefDefNetwork() const;
   void initFlute(const char *resizer_path);
 
-  void readDef(const char *filename);
+  // Lean mode drops the DEF component records after the fields the
+  // resizer uses are extracted, so write_def omits the component
+  // attributes (EEQMASTER, SOURCE, REGION, ...) it would round trip.
+  void readDef(const char *filename,
+	       bool lean);
+  void readSnapshot(const char *filename);
 
   // Set the resistance and capacitance used for parasitics.
   // Make net wire parasitics based on DEF locations.
   void setWireRC(float wire_res, // ohms/meter
 		 float wire_cap, // farads/meter
 		 Corner *corner);
+  // Worker thread count for parallel passes (1 is serial).
+  void setThreadCount(int thread_count);
+  int threadCount() const { return thread_count_; }
 
   // Die area (meters).
   double dieArea() const;
@@ -85,40 +108,88 @@ public:
   // resizerPreamble() required.
   void resizeToTargetSlew(Instance *inst);
 
-  // Insert buffers to fix max cap/slew violations.
+  // Insert buffers to fix max cap/slew violations. All drive
+  // strengths in buffer_cells compete within one bottom up pass.
+  // max_nets > 0 bounds the pass to the worst max_nets nets.
   // resizerPreamble() required.
   void rebufferNets(bool repair_max_cap,
 		    bool repair_max_slew,
-		    LibertyCell *buffer_cell);
+		    LibertyCellSeq *buffer_cells,
+		    int max_nets);
   // Rebuffer net (for testing).
   // Assumes buffer_cell->isBuffer() is true.
   // resizerPreamble() required.
   void rebuffer(Net *net,
 		LibertyCell *buffer_cell);
+  // Bound the rebuffer option frontier width (0 is unbounded).
+  void setRebufferMaxOptions(int max_options);
   Slew targetSlew(const TransRiseFall *tr);
   float targetLoadCap(LibertyCell *cell);
   // Area of the design in meter^2.
   double designArea();
+  // Timers/counters around the resizer kernels (report_resizer_stats).
+  ResizerStats *stats() { return stats_; }
+
+  // Erase cached state (steiner trees) for nets touched by edits.
+  virtual void connectPin(Instance *inst,
+			  Port *port,
+			  Net *net);
+  virtual void connectPin(Instance *inst,
+			  LibertyPort *port,
+			  Net *net);
+  virtual void disconnectPin(Pin *pin);
+  virtual void deleteInstance(Instance *inst);
+  virtual void deleteNet(Net *net);
+  // Bulk pin move between nets with a single invalidation pass
+  // instead of one per disconnect/connect.
+  void movePins(Net *from,
+		Net *to,
+		PinSeq &pins);
+  // Clock edits invalidate the cached clock net membership.
+  virtual void makeClock(const char *name,
+			 PinSet *pins,
+			 bool add_to_pins,
+			 float period,
+			 FloatSeq *waveform,
+			 char *comment);
+  virtual void removeClock(Clock *clk);
 
 protected:
   virtual void makeNetwork();
   virtual void makeCmdNetwork();
   void ensureCorner();
+  void designChanged();
   void initCorner(Corner *corner);
   void ensureClkNets();
   void findClkNets();
+  void clkNetsInvalid();
   bool isClock(Net *net);
+  // Nets made by splitting net inherit its clock membership so the
+  // set stays correct across edits without re-running the BFS.
+  void inheritClkNet(Net *net,
+		     Net *new_net);
   void ensureLevelDrvrVerticies();
+  void insertLevelDrvrVertex(Vertex *drvr_vertex);
   void bufferInput(Pin *top_pin,
 		   LibertyCell *buffer_cell);
   void bufferOutput(Pin *top_pin,
 		    LibertyCell *buffer_cell);
   void makeEquivCells(LibertyLibrarySeq *resize_libs);
+  void resizeToTargetSlewParallel();
+  LibertyCell *findTargetCell(Instance *inst);
+  void replaceTargetCell(Instance *inst,
+			 LibertyCell *best_cell);
   void findTargetLoads(LibertyLibrarySeq *resize_libs);
+  void findTargetLoadCells();
+  void findTargetLoadsParallel(LibertyLibrary *library);
   void findTargetLoads(LibertyLibrary *library,
 		       Slew slews[]);
-  void findTargetLoad(LibertyCell *cell,
-		      Slew slews[]);
+  // On-disk characterization cache, one file per liberty library.
+  TargetLoadCacheEntry *readTargetLoadCache(LibertyLibrary *library);
+  void writeTargetLoadCache(LibertyLibrary *library,
+			    TargetLoadCacheEntry *entry);
+  float findTargetLoad(LibertyCell *cell,
+		       Slew slews[]);
   float findTargetLoad(LibertyCell *cell,
 		       TimingArc *arc,
 		       Slew in_slew,
@@ -129,67 +200,151 @@ protected:
 			     Slew slews[],
 			     int counts[]);
   void makeNetParasitics();
+  void makeNetParasiticsParallel(NetSeq &nets);
   void makeNetParasitics(const Net *net);
+  void makeNetParasitics(const Net *net,
+			 SteinerTree *tree);
+  // Cached steiner tree for net, built on the first request.
+  SteinerTree *steinerTree(const Net *net,
+			   bool find_left_rights);
   ParasiticNode *findParasiticNode(SteinerTree *tree,
 				   Parasitic *parasitic,
 				   const Net *net,
 				   const Pin *pin,
 				   int steiner_pt);
 
-  // Assumes buffer_cell->isBuffer() is true.
+  // Assumes isBuffer() is true for all of buffer_cells.
   void rebuffer(bool repair_max_cap,
 		bool repair_max_slew,
-		LibertyCell *buffer_cell);
+		LibertyCellSeq &buffer_cells,
+		int max_nets);
   void rebuffer(const Pin *drvr_pin,
-		LibertyCell *buffer_cell);
-  bool hasMaxCapViolation(const Pin *drvr_pin);
-  bool hasMaxSlewViolation(const Pin *drvr_pin);
+		LibertyCellSeq &buffer_cells);
+  // Guards and cached steiner tree shared by the serial and parallel
+  // rebuffer passes. Returns false when the driver is not a
+  // candidate for rebuffering.
+  bool rebufferPreamble(const Pin *drvr_pin,
+			LibertyCellSeq &buffer_cells,
+			// Return values.
+			Net *&net,
+			LibertyPort *&drvr_port,
+			SteinerTree *&tree);
+  // Bottom up option search and driver argmax. Read-only once the
+  // sink requireds are prefetched, so worker threads can run it
+  // concurrently on distinct nets with private arenas.
+  RebufferOption *bestRebufferOption(const Pin *drvr_pin,
+				     LibertyPort *drvr_port,
+				     SteinerTree *tree,
+				     LibertyCellSeq &buffer_cells,
+				     RebufferOptionArena *arena);
+  // Search the violating drivers in parallel batches, then commit
+  // the winning options serially after each batch.
+  void rebufferParallel(DrvrViolationSeq &violations,
+			LibertyCellSeq &buffer_cells,
+			int max_nets);
+  // One sweep over the driver vertices finding limit violations,
+  // sorted worst first.
+  void findViolatingDrvrs(bool repair_max_cap,
+			  bool repair_max_slew,
+			  // Return value.
+			  DrvrViolationSeq &violations);
+  // Relative limit excess; zero when there is no violation.
+  float capViolationSeverity(const Pin *drvr_pin);
+  float slewViolationSeverity(Vertex *vertex,
+			      float limit,
+			      bool limit_exists);
+  // Batch form of slewLimit for sweeps over many drivers: the design
+  // limit is resolved once and the liberty port limits once per
+  // distinct port instead of once per pin.
+  void findSlewLimits(const VertexSeq &drvrs,
+		      const MinMax *min_max,
+		      // Return values.
+		      Vector<float> &limits,
+		      Vector<bool> &limit_exists);
   void slewLimit(const Pin *pin,
 		 const MinMax *min_max,
 		 // Return values.
 		 float &limit,
 		 bool &exists) const;
+  // Limit resolution with the top cell ("design") limit hoisted out
+  // so sweeps resolve it once.
+  void pinSlewLimit(const Pin *pin,
+		    const MinMax *min_max,
+		    float top_limit,
+		    bool top_limit_exists,
+		    // Return values.
+		    float &limit,
+		    bool &exists) const;
 			
+  void pruneRebufferOptions(RebufferOptionSeq &Z);
   RebufferOptionSeq rebufferBottomUp(SteinerTree *tree,
 				     SteinerPt k,
 				     SteinerPt prev,
 				     int level,
-				     LibertyCell *buffer_cell);
+				     LibertyCellSeq &buffer_cells,
+				     RebufferOptionArena *arena);
   void rebufferTopDown(RebufferOption *choice,
 		       Net *net,
-		       int level,
-		       LibertyCell *buffer_cell);
+		       int level);
+  // All rebuffer options for one net are carved from this arena and
+  // freed together after the winning option is committed.
+  RebufferOptionArena *rebufferOptionArena();
   RebufferOptionSeq
   addWireAndBuffer(RebufferOptionSeq Z,
 		   SteinerTree *tree,
 		   SteinerPt k,
 		   SteinerPt prev,
 		   int level,
-		   LibertyCell *buffer_cell);
+		   LibertyCellSeq &buffer_cells,
+		   RebufferOptionArena *arena);
   float portCapacitance(const LibertyPort *port);
   float pinCapacitance(const Pin *pin);
   float bufferInputCapacitance(LibertyCell *buffer_cell);
   Required pinRequired(const Pin *pin);
   Required vertexRequired(Vertex *vertex,
 			  const MinMax *min_max);
+  void prefetchRequireds(SteinerTree *tree);
+  void requiredsInvalid(const Net *net);
+  // Invalidate delays/arrivals/requireds only for the cones touching
+  // the net so the next findDelays/findRequired is incremental.
+  void timingInvalid(const Net *net);
+  void timingInvalid(Vertex *vertex);
   float gateDelay(LibertyPort *out_port,
 		  float load_cap);
+  // Batched form so callers with many load candidates pay the arc
+  // walk and table setup once.
+  void gateDelays(LibertyPort *out_port,
+		  const float *load_caps,
+		  int count,
+		  // Return values.
+		  float *delays);
   float bufferDelay(LibertyCell *buffer_cell,
 		    float load_cap);
+  void bufferDelays(LibertyCell *buffer_cell,
+		    const float *load_caps,
+		    int count,
+		    // Return values.
+		    float *delays);
+  // Flattened NLDM surfaces for arc, or nullptr if the arc's tables
+  // cannot be flattened. Lazy; thread safe.
+  FlatArcModel *flatArcModel(LibertyCell *cell,
+			     TimingArc *arc);
   string makeUniqueNetName();
   string makeUniqueBufferName();
   bool dontUse(LibertyCell *cell);
   bool overMaxArea();
   bool hasTopLevelOutputPort(Net *net);
 
-  friend class RebufferOption;
   using Sta::makeEquivCells;
 
   float wire_res_;
   float wire_cap_;
   Corner *corner_;
+  bool have_parasitics_;
+  int thread_count_;
   LibertyCellSet dont_use_;
   double max_area_;
+  int rebuffer_max_options_;
   // Die area (meters).
   double die_lx_;
   double die_ly_;
@@ -207,17 +362,28 @@ protected:
   const ParasiticAnalysisPt *parasitics_ap_;
   NetSet clk_nets_;
   bool clk_nets__valid_;
+  SteinerTreeCache steiner_tree_cache_;
+  RebufferOptionArena *rebuffer_option_arena_;
+  ResizerStats *stats_;
+  // Cached max path requireds, erased when an edit touches the
+  // vertex's net.
+  VertexRequiredMap vertex_required_map_;
+  FlatArcModelMap flat_arc_models_;
+  std::mutex flat_arc_lock_;
+  std::mutex dcalc_lock_;
+  TargetLoadCacheMap target_load_cache_;
   CellTargetLoadMap *target_load_map_;
+  // Per equiv class candidate tables sorted by target load, shared
+  // by every member of the class; the table vector owns them.
+  CellTargetLoadCellsMap cell_target_load_cells_;
+  Vector<TargetLoadCellSeq*> target_load_cell_tables_;
   VertexSeq level_drvr_verticies_;
   bool level_drvr_verticies_valid_;
   Slew tgt_slews_[TransRiseFall::index_count];
-  int unique_net_index_;
-  int unique_buffer_index_;
   int resize_count_;
   int inserted_buffer_count_;
   int rebuffer_net_count_;
   double core_area_;
-  double design_area_;
 };
 
 } // namespace
@@ -27,7 +27,10 @@
 #include "LefReader.hh"
 #include "DefReader.hh"
 #include "DefWriter.hh"
+#include "Snapshot.hh"
+#include "BenchDesign.hh"
 #include "LefDefNetwork.hh"
+#include "ResizerStats.hh"
 #include "Resizer.hh"
 
 namespace sta {
@@ -135,10 +138,25 @@ lef_exists()
 }
 
 void
-read_def(const char *filename)
+read_def_cmd(const char *filename,
+	     bool lean)
 {
   Resizer *resizer = getResizer();
-  resizer->readDef(filename);
+  resizer->readDef(filename, lean);
+}
+
+void
+write_snapshot(const char *filename)
+{
+  LefDefNetwork *network = lefDefNetwork();
+  writeSnapshot(filename, network);
+}
+
+void
+read_snapshot(const char *filename)
+{
+  Resizer *resizer = getResizer();
+  resizer->readSnapshot(filename);
 }
 
 void
@@ -202,18 +220,22 @@ write_def_cmd(const char *filename,
   resizer->dieSize(die_lx, die_ly, die_ux, die_uy);
   double core_lx, core_ly, core_ux, core_uy;
   resizer->coreSize(core_lx, core_ly, core_ux, core_uy);
+  ResizerPhaseTimer timer(resizer->stats(), resizer_phase_def_write);
   writeDef(filename, units,
 	   die_lx, die_ly, die_ux, die_uy,
 	   core_lx, core_ly, core_ux, core_uy,
-	   site_name, tracks_file, auto_place_pins, sort, network);
+	   site_name, tracks_file, auto_place_pins, sort,
+	   resizer->threadCount(), network);
 }
 
 void
 set_wire_rc_cmd(float res,
 		float cap,
-		Corner *corner)
+		Corner *corner,
+		int threads)
 {
   Resizer *resizer = getResizer();
+  resizer->setThreadCount(threads);
   resizer->setWireRC(res, cap, corner);
 }
 
@@ -262,10 +284,12 @@ resize_to_target_slew()
 void
 rebuffer_nets(bool repair_max_cap,
 	      bool repair_max_slew,
-	      LibertyCell *buffer_cell)
+	      LibertyCellSeq *buffer_cells,
+	      int max_nets)
 {
   Resizer *resizer = getResizer();
-  resizer->rebufferNets(repair_max_cap, repair_max_slew, buffer_cell);
+  resizer->rebufferNets(repair_max_cap, repair_max_slew, buffer_cells,
+			max_nets);
 }
 
 void
@@ -275,6 +299,13 @@ resize_instance_to_target_slew(Instance *inst)
   resizer->resizeToTargetSlew(inst);
 }
 
+void
+set_rebuffer_max_options(int max_options)
+{
+  Resizer *resizer = getResizer();
+  resizer->setRebufferMaxOptions(max_options);
+}
+
 void
 rebuffer_net(Net *net,
 	     LibertyCell *buffer_cell)
@@ -304,4 +335,36 @@ design_area()
   return resizer->designArea();
 }
 
+void
+report_resizer_stats_cmd()
+{
+  Resizer *resizer = getResizer();
+  resizer->stats()->report(resizer->report());
+}
+
+void
+report_resizer_stats_json(const char *filename)
+{
+  Resizer *resizer = getResizer();
+  resizer->stats()->reportJson(filename);
+}
+
+void
+clear_resizer_stats()
+{
+  Resizer *resizer = getResizer();
+  resizer->stats()->clear();
+}
+
+void
+make_bench_design_cmd(LibertyCell *cell,
+		      int inst_count,
+		      int max_fanout,
+		      double spread,
+		      int seed)
+{
+  LefDefNetwork *network = lefDefNetwork();
+  makeBenchDesign(cell, inst_count, max_fanout, spread, seed, network);
+}
+
 %} // inline
@@ -31,7 +31,19 @@ define_cmd_args "set_dont_use" {cell dont_use}
 # Defined by SWIG interface Resizer.i
 define_cmd_args "read_lef" {filename}
 
-define_cmd_args "read_def" {filename}
+define_cmd_args "read_def" {[-lean] filename}
+
+# -lean drops the DEF component records the resizer does not use, at
+# the cost of write_def not round tripping component attributes.
+proc read_def { args } {
+  parse_key_args "read_def" args keys {} flags {-lean}
+  check_argc_eq1 "read_def" $args
+  read_def_cmd [lindex $args 0] [info exists flags(-lean)]
+}
+
+define_cmd_args "write_snapshot" {filename}
+
+define_cmd_args "read_snapshot" {filename}
 
 define_cmd_args "set_design_size" {[-die {lx ly ux uy}]\
 				     [-core {lx ly ux uy}]}
@@ -149,11 +161,12 @@ proc write_def { args } {
 }
 
 define_cmd_args "set_wire_rc" {[-resistance res ][-capacitance cap]\
-				 [-corner corner_name]}
+				 [-corner corner_name]\
+				 [-threads thread_count]}
 
 proc set_wire_rc { args } {
    parse_key_args "set_wire_rc" args \
-    keys {-resistance -capacitance -corner} flags {}
+    keys {-resistance -capacitance -corner -threads} flags {}
 
   set wire_res 0.0
   if [info exists keys(-resistance)] {
@@ -166,10 +179,15 @@ proc set_wire_rc { args } {
     check_positive_float "-capacitance" $cap
   }
   set corner [parse_corner keys]
+  set threads 1
+  if [info exists keys(-threads)] {
+    set threads $keys(-threads)
+    check_positive_integer "-threads" $threads
+  }
   check_argc_eq0 "set_wire_rc" $args
   set r [expr [resistance_ui_sta $res] / [distance_ui_sta 1.0]]
   set c [expr [capacitance_ui_sta $cap] / [distance_ui_sta 1.0]]
-  set_wire_rc_cmd $r $c $corner
+  set_wire_rc_cmd $r $c $corner $threads
 }
 
 define_cmd_args "resize" {[-buffer_inputs]\
@@ -179,11 +197,15 @@ define_cmd_args "resize" {[-buffer_inputs]\
 			    [-repair_max_slew]\
 			    [-resize_libraries resize_libs]\
 			    [-buffer_cell buffer_cell]\
-			    [-dont_use lib_cells]}
+			    [-buffer_cells buffer_cells]\
+			    [-dont_use lib_cells]\
+			    [-max_nets max_nets]\
+			    [-max_options max_options]}
 
 proc resize { args } {
   parse_key_args "resize" args \
-    keys {-buffer_cell -resize_libraries -dont_use -max_utilization} \
+    keys {-buffer_cell -buffer_cells -resize_libraries -dont_use \
+	    -max_utilization -max_nets -max_options} \
     flags {-buffer_inputs -buffer_outputs -resize -repair_max_cap -repair_max_slew}
 
   set buffer_inputs [info exists flags(-buffer_inputs)]
@@ -213,6 +235,22 @@ proc resize { args } {
       }
     }
   }
+  # All drive strengths in -buffer_cells compete in one rebuffer pass.
+  set buffer_cells {}
+  if { [info exists keys(-buffer_cells)] } {
+    set buffer_cells [get_lib_cells_arg "-buffer_cells" $keys(-buffer_cells) sta_error]
+    foreach buf_cell $buffer_cells {
+      if { ![get_property $buf_cell is_buffer] } {
+	sta_error "Error: [get_name $buf_cell] is not a buffer."
+      }
+    }
+  }
+  if { $buffer_cells == {} && $buffer_cell != "NULL" } {
+    set buffer_cells [list $buffer_cell]
+  }
+  if { $buffer_cell == "NULL" && $buffer_cells != {} } {
+    set buffer_cell [lindex $buffer_cells 0]
+  }
   if { $buffer_cell == "NULL" && ($buffer_inputs || $buffer_outputs \
 				    || $repair_max_cap || $repair_max_slew) } {
     sta_error "Error: resize -buffer_cell required for buffer insertion."
@@ -238,11 +276,27 @@ proc resize { args } {
     set max_util [expr $max_util / 100.0]
   }
 
+  set max_nets 0
+  if { [info exists keys(-max_nets)] } {
+    set max_nets $keys(-max_nets)
+    if {!([string is integer $max_nets] && $max_nets >= 0)} {
+      sta_error "-max_nets must be a positive integer."
+    }
+  }
+
+  set max_options 0
+  if { [info exists keys(-max_options)] } {
+    set max_options $keys(-max_options)
+    if {!([string is integer $max_options] && $max_options >= 2)} {
+      sta_error "-max_options must be an integer greater than one."
+    }
+  }
   check_argc_eq0 "resize" $args
 
   resizer_preamble $resize_libs
   set_dont_use $dont_use
   set_max_utilization $max_util
+  set_rebuffer_max_options $max_options
   if { $buffer_inputs } {
     buffer_inputs $buffer_cell
   }
@@ -253,7 +307,7 @@ proc resize { args } {
     resize_to_target_slew
   }
   if { $repair_max_cap || $repair_max_slew } {
-    rebuffer_nets $repair_max_cap $repair_max_slew $buffer_cell
+    rebuffer_nets $repair_max_cap $repair_max_slew $buffer_cells $max_nets
   }
 }
 
@@ -272,5 +326,65 @@ proc report_design_area {} {
   puts "Design area ${area} u^2 ${util}% utilization."
 }
 
+define_cmd_args "report_resizer_stats" {[-json filename]}
+
+# Report the timers/counters accumulated around the resizer kernels.
+# -json writes them to filename for machine consumption instead.
+proc report_resizer_stats { args } {
+  parse_key_args "report_resizer_stats" args keys {-json} flags {}
+  check_argc_eq0 "report_resizer_stats" $args
+  if { [info exists keys(-json)] } {
+    report_resizer_stats_json $keys(-json)
+  } else {
+    report_resizer_stats_cmd
+  }
+}
+
+# Defined by SWIG interface Resizer.i.
+define_cmd_args "clear_resizer_stats" {}
+
+define_cmd_args "make_bench_design" {-cell buffer_cell\
+				       [-instances inst_count]\
+				       [-max_fanout max_fanout]\
+				       [-spread spread]\
+				       [-seed seed]}
+
+# Synthesize a placed random tree design for benchmarking the resizer
+# kernels (see test/bench.tcl). Requires read_liberty and read_lef.
+proc make_bench_design { args } {
+  parse_key_args "make_bench_design" args \
+    keys {-cell -instances -max_fanout -spread -seed} flags {}
+
+  if { ![info exists keys(-cell)] } {
+    sta_error "Error: make_bench_design -cell required."
+  }
+  set cell [get_lib_cell_error "-cell" $keys(-cell)]
+  if { ![get_property $cell is_buffer] } {
+    sta_error "Error: [get_name $cell] is not a buffer."
+  }
+  set inst_count 10000
+  if { [info exists keys(-instances)] } {
+    set inst_count $keys(-instances)
+    check_positive_integer "-instances" $inst_count
+  }
+  set max_fanout 4
+  if { [info exists keys(-max_fanout)] } {
+    set max_fanout $keys(-max_fanout)
+    check_positive_integer "-max_fanout" $max_fanout
+  }
+  set spread 1.0
+  if { [info exists keys(-spread)] } {
+    set spread $keys(-spread)
+    check_positive_float "-spread" $spread
+  }
+  set seed 1
+  if { [info exists keys(-seed)] } {
+    set seed $keys(-seed)
+    check_positive_integer "-seed" $seed
+  }
+  check_argc_eq0 "make_bench_design" $args
+  make_bench_design_cmd $cell $inst_count $max_fanout $spread $seed
+}
+
 # sta namespace end
 }
@@ -0,0 +1,175 @@
+// Resizer, LEF/DEF gate resizer
+// Copyright (c) 2019, Parallax Software, Inc.
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+#include <stdio.h>
+#include "Machine.hh"
+#include "Error.hh"
+#include "Report.hh"
+#include "ResizerStats.hh"
+
+namespace sta {
+
+ResizerStats::ResizerStats()
+{
+  clear();
+}
+
+void
+ResizerStats::clear()
+{
+  for (int phase = 0; phase < resizer_phase_count; phase++) {
+    time_[phase] = 0.0;
+    calls_[phase] = 0;
+    bytes_[phase] = 0;
+  }
+  for (int b = 0; b < fanout_bucket_count; b++) {
+    fanout_nets_[b] = 0;
+    fanout_time_[b] = 0.0;
+  }
+}
+
+void
+ResizerStats::incrTime(ResizerPhase phase,
+		       double secs)
+{
+  time_[phase] += secs;
+}
+
+void
+ResizerStats::incrCalls(ResizerPhase phase,
+			int64_t count)
+{
+  calls_[phase] += count;
+}
+
+void
+ResizerStats::incrBytes(ResizerPhase phase,
+			int64_t bytes)
+{
+  bytes_[phase] += bytes;
+}
+
+void
+ResizerStats::recordRebufferNet(int fanout,
+				double secs)
+{
+  int bucket = 0;
+  while (bucket < fanout_bucket_count - 1
+	 && fanout >= (2 << bucket))
+    bucket++;
+  fanout_nets_[bucket]++;
+  fanout_time_[bucket] += secs;
+}
+
+const char *
+ResizerStats::phaseName(ResizerPhase phase)
+{
+  switch (phase) {
+  case resizer_phase_def_read:
+    return "def read";
+  case resizer_phase_def_write:
+    return "def write";
+  case resizer_phase_steiner:
+    return "steiner trees";
+  case resizer_phase_parasitics:
+    return "parasitics";
+  case resizer_phase_target_loads:
+    return "target loads";
+  case resizer_phase_resize:
+    return "resize";
+  case resizer_phase_rebuffer:
+    return "rebuffer";
+  default:
+    return "unknown";
+  }
+}
+
+void
+ResizerStats::report(Report *report) const
+{
+  report->print("Phase               calls     time (s)   alloc (MB)\n");
+  for (int phase = 0; phase < resizer_phase_count; phase++)
+    report->print("%-15s %9lld %12.3f %12.3f\n",
+		  phaseName(static_cast<ResizerPhase>(phase)),
+		  static_cast<long long>(calls_[phase].load()),
+		  time_[phase],
+		  bytes_[phase].load() / 1e6);
+  report->print("Rebuffer fanout      nets     time (s)\n");
+  for (int b = 0; b < fanout_bucket_count; b++) {
+    if (fanout_nets_[b] > 0) {
+      int fanout_min = (b == 0) ? 0 : (1 << b);
+      int fanout_max = (2 << b) - 1;
+      report->print("%5d -%6d   %9lld %12.3f\n",
+		    fanout_min,
+		    fanout_max,
+		    static_cast<long long>(fanout_nets_[b]),
+		    fanout_time_[b]);
+    }
+  }
+}
+
+void
+ResizerStats::reportJson(const char *filename) const
+{
+  FILE *stream = fopen(filename, "w");
+  if (stream) {
+    fprintf(stream, "{\n \"phases\": {\n");
+    for (int phase = 0; phase < resizer_phase_count; phase++)
+      fprintf(stream,
+	      "  \"%s\": {\"calls\": %lld, \"time_sec\": %.6f, \"bytes\": %lld}%s\n",
+	      phaseName(static_cast<ResizerPhase>(phase)),
+	      static_cast<long long>(calls_[phase].load()),
+	      time_[phase],
+	      static_cast<long long>(bytes_[phase].load()),
+	      (phase == resizer_phase_count - 1) ? "" : ",");
+    fprintf(stream, " },\n \"rebuffer_fanout_histogram\": [\n");
+    bool first = true;
+    for (int b = 0; b < fanout_bucket_count; b++) {
+      if (fanout_nets_[b] > 0) {
+	fprintf(stream,
+		"%s  {\"fanout_min\": %d, \"fanout_max\": %d, \"nets\": %lld, \"time_sec\": %.6f}",
+		first ? "" : ",\n",
+		(b == 0) ? 0 : (1 << b),
+		(2 << b) - 1,
+		static_cast<long long>(fanout_nets_[b]),
+		fanout_time_[b]);
+	first = false;
+      }
+    }
+    fprintf(stream, "\n ]\n}\n");
+    fclose(stream);
+  }
+  else
+    throw FileNotWritable(filename);
+}
+
+ResizerPhaseTimer::ResizerPhaseTimer(ResizerStats *stats,
+				     ResizerPhase phase) :
+  stats_(stats),
+  phase_(phase),
+  start_(std::chrono::steady_clock::now())
+{
+}
+
+ResizerPhaseTimer::~ResizerPhaseTimer()
+{
+  std::chrono::duration<double> elapsed =
+    std::chrono::steady_clock::now() - start_;
+  stats_->incrTime(phase_, elapsed.count());
+  stats_->incrCalls(phase_);
+}
+
+} // namespace
@@ -0,0 +1,87 @@
+// Resizer, LEF/DEF gate resizer
+// Copyright (c) 2019, Parallax Software, Inc.
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+#ifndef RESIZER_RESIZER_STATS_H
+#define RESIZER_RESIZER_STATS_H
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+
+namespace sta {
+
+class Report;
+
+// Instrumented resizer phases.
+enum ResizerPhase {
+  resizer_phase_def_read,
+  resizer_phase_def_write,
+  resizer_phase_steiner,
+  resizer_phase_parasitics,
+  resizer_phase_target_loads,
+  resizer_phase_resize,
+  resizer_phase_rebuffer,
+  resizer_phase_count
+};
+
+// Wall time, call counts and allocation volume accumulated around the
+// resizer kernels, with a fanout histogram for rebuffered nets.
+// The counters are atomic so worker threads can bump them; times are
+// only accumulated on the command thread.
+class ResizerStats
+{
+public:
+  ResizerStats();
+  void clear();
+  void incrTime(ResizerPhase phase,
+		double secs);
+  void incrCalls(ResizerPhase phase,
+		 int64_t count = 1);
+  void incrBytes(ResizerPhase phase,
+		 int64_t bytes);
+  // Power of two fanout buckets.
+  void recordRebufferNet(int fanout,
+			 double secs);
+  void report(Report *report) const;
+  void reportJson(const char *filename) const;
+
+private:
+  static const char *phaseName(ResizerPhase phase);
+
+  static const int fanout_bucket_count = 16;
+  double time_[resizer_phase_count];
+  std::atomic<int64_t> calls_[resizer_phase_count];
+  std::atomic<int64_t> bytes_[resizer_phase_count];
+  int64_t fanout_nets_[fanout_bucket_count];
+  double fanout_time_[fanout_bucket_count];
+};
+
+// Adds the wall time of its scope to a phase.
+class ResizerPhaseTimer
+{
+public:
+  ResizerPhaseTimer(ResizerStats *stats,
+		    ResizerPhase phase);
+  ~ResizerPhaseTimer();
+
+private:
+  ResizerStats *stats_;
+  ResizerPhase phase_;
+  std::chrono::steady_clock::time_point start_;
+};
+
+} // namespace
+#endif
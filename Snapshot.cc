@@ -0,0 +1,479 @@
+// Resizer, LEF/DEF gate resizer
+// Copyright (c) 2019, Parallax Software, Inc.
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+#include <stdio.h>
+#include <stdint.h>
+#include <string.h>
+#include <string>
+#include "Machine.hh"
+#include "Report.hh"
+#include "Error.hh"
+#include "PortDirection.hh"
+#include "LefDefNetwork.hh"
+#include "Snapshot.hh"
+
+// Binary image of the DEF derived network. The format is a single
+// sequential stream of records in native byte order, so loading is
+// one read and a linear walk instead of the DEF parse.
+
+namespace sta {
+
+using std::string;
+
+// "RSNP"
+static const uint32_t snapshot_magic = 0x52534e50;
+static const uint32_t snapshot_version = 1;
+// Flush the output buffer when it grows to this size.
+static const size_t snapshot_flush_size = 1024 * 1024;
+
+static char
+directionChar(PortDirection *dir);
+static PortDirection *
+charDirection(char dir_char);
+
+////////////////////////////////////////////////////////////////
+
+class SnapshotWriter
+{
+public:
+  SnapshotWriter(const char *filename);
+  ~SnapshotWriter();
+  void writeU8(uint8_t value);
+  void writeU32(uint32_t value);
+  void writeS32(int32_t value);
+  void writeString(const char *value);
+
+private:
+  void flush();
+
+  FILE *stream_;
+  string buf_;
+};
+
+SnapshotWriter::SnapshotWriter(const char *filename)
+{
+  stream_ = fopen(filename, "wb");
+  if (stream_ == nullptr)
+    throw FileNotWritable(filename);
+}
+
+SnapshotWriter::~SnapshotWriter()
+{
+  flush();
+  fclose(stream_);
+}
+
+void
+SnapshotWriter::flush()
+{
+  if (!buf_.empty()) {
+    fwrite(buf_.data(), 1, buf_.size(), stream_);
+    buf_.clear();
+  }
+}
+
+void
+SnapshotWriter::writeU8(uint8_t value)
+{
+  buf_.push_back(static_cast<char>(value));
+}
+
+void
+SnapshotWriter::writeU32(uint32_t value)
+{
+  buf_.append(reinterpret_cast<const char*>(&value), sizeof(value));
+  if (buf_.size() >= snapshot_flush_size)
+    flush();
+}
+
+void
+SnapshotWriter::writeS32(int32_t value)
+{
+  writeU32(static_cast<uint32_t>(value));
+}
+
+void
+SnapshotWriter::writeString(const char *value)
+{
+  uint32_t length = strlen(value);
+  writeU32(length);
+  buf_.append(value, length);
+}
+
+////////////////////////////////////////////////////////////////
+
+class SnapshotReader
+{
+public:
+  SnapshotReader(const char *filename);
+  ~SnapshotReader();
+  bool corrupt() const { return corrupt_; }
+  uint8_t readU8();
+  uint32_t readU32();
+  int32_t readS32();
+  // Valid until the next read.
+  const char *readString();
+
+private:
+  char *buf_;
+  size_t size_;
+  size_t pos_;
+  bool corrupt_;
+  string string_buf_;
+};
+
+SnapshotReader::SnapshotReader(const char *filename) :
+  buf_(nullptr),
+  size_(0),
+  pos_(0),
+  corrupt_(false)
+{
+  FILE *stream = fopen(filename, "rb");
+  if (stream == nullptr)
+    throw FileNotReadable(filename);
+  fseek(stream, 0, SEEK_END);
+  size_ = ftell(stream);
+  fseek(stream, 0, SEEK_SET);
+  buf_ = new char[size_];
+  if (fread(buf_, 1, size_, stream) != size_)
+    corrupt_ = true;
+  fclose(stream);
+}
+
+SnapshotReader::~SnapshotReader()
+{
+  delete [] buf_;
+}
+
+uint8_t
+SnapshotReader::readU8()
+{
+  if (pos_ + 1 > size_) {
+    corrupt_ = true;
+    return 0;
+  }
+  return static_cast<uint8_t>(buf_[pos_++]);
+}
+
+uint32_t
+SnapshotReader::readU32()
+{
+  uint32_t value;
+  if (pos_ + sizeof(value) > size_) {
+    corrupt_ = true;
+    return 0;
+  }
+  memcpy(&value, &buf_[pos_], sizeof(value));
+  pos_ += sizeof(value);
+  return value;
+}
+
+int32_t
+SnapshotReader::readS32()
+{
+  return static_cast<int32_t>(readU32());
+}
+
+const char *
+SnapshotReader::readString()
+{
+  uint32_t length = readU32();
+  if (pos_ + length > size_) {
+    corrupt_ = true;
+    length = 0;
+  }
+  string_buf_.assign(&buf_[pos_], length);
+  pos_ += length;
+  return string_buf_.c_str();
+}
+
+////////////////////////////////////////////////////////////////
+
+void
+writeSnapshot(const char *filename,
+	      LefDefNetwork *network)
+{
+  Library *lef_library = network->lefLibrary();
+  if (lef_library == nullptr) {
+    network->report()->printError("Error; no LEF library has been read.\n");
+    return;
+  }
+  SnapshotWriter writer(filename);
+  writer.writeU32(snapshot_magic);
+  writer.writeU32(snapshot_version);
+
+  Instance *top_instance = network->topInstance();
+  Cell *top_cell = network->cell(top_instance);
+  ConcreteLibrary *lef_clib = reinterpret_cast<ConcreteLibrary*>(lef_library);
+  writer.writeU8(network->pathDivider());
+  writer.writeU8(lef_clib->busBrktLeft());
+  writer.writeU8(lef_clib->busBrktRight());
+  writer.writeS32(network->defUnits());
+  DefDbu die_lx, die_ly, die_ux, die_uy;
+  network->dieArea(die_lx, die_ly, die_ux, die_uy);
+  writer.writeS32(die_lx);
+  writer.writeS32(die_ly);
+  writer.writeS32(die_ux);
+  writer.writeS32(die_uy);
+  writer.writeString(network->name(top_cell));
+
+  // Top level ports, bit by bit; buses regroup on load.
+  uint32_t port_count = 0;
+  CellPortBitIterator *count_iter = network->portBitIterator(top_cell);
+  while (count_iter->hasNext()) {
+    count_iter->next();
+    port_count++;
+  }
+  delete count_iter;
+  writer.writeU32(port_count);
+  CellPortBitIterator *port_iter = network->portBitIterator(top_cell);
+  while (port_iter->hasNext()) {
+    Port *port = port_iter->next();
+    writer.writeString(network->name(port));
+    writer.writeU8(directionChar(network->direction(port)));
+    DefPt location;
+    bool placed = network->portLocation(port, location);
+    writer.writeU8(placed);
+    writer.writeS32(placed ? location.x() : 0);
+    writer.writeS32(placed ? location.y() : 0);
+  }
+  delete port_iter;
+
+  // Components with their placement records.
+  uint32_t component_count = 0;
+  LeafInstanceIterator *leaf_count_iter = network->leafInstanceIterator();
+  while (leaf_count_iter->hasNext()) {
+    leaf_count_iter->next();
+    component_count++;
+  }
+  delete leaf_count_iter;
+  writer.writeU32(component_count);
+  LeafInstanceIterator *leaf_iter = network->leafInstanceIterator();
+  while (leaf_iter->hasNext()) {
+    Instance *inst = leaf_iter->next();
+    writer.writeString(network->name(inst));
+    writer.writeString(network->name(network->cell(inst)));
+    const InstanceLocation *loc = network->instanceLocation(inst);
+    writer.writeS32(loc ? loc->x_ : 0);
+    writer.writeS32(loc ? loc->y_ : 0);
+    writer.writeS32(loc ? loc->orient_ : 0);
+    writer.writeS32(loc ? loc->status_ : 0);
+  }
+  delete leaf_iter;
+
+  // Nets and their connections.
+  uint32_t net_count = 0;
+  NetIterator *net_count_iter = network->netIterator(top_instance);
+  while (net_count_iter->hasNext()) {
+    net_count_iter->next();
+    net_count++;
+  }
+  delete net_count_iter;
+  writer.writeU32(net_count);
+  NetIterator *net_iter = network->netIterator(top_instance);
+  while (net_iter->hasNext()) {
+    Net *net = net_iter->next();
+    writer.writeString(network->name(net));
+    uint32_t conn_count = 0;
+    NetConnectedPinIterator *conn_count_iter =
+      network->connectedPinIterator(net);
+    while (conn_count_iter->hasNext()) {
+      conn_count_iter->next();
+      conn_count++;
+    }
+    delete conn_count_iter;
+    writer.writeU32(conn_count);
+    NetConnectedPinIterator *pin_iter = network->connectedPinIterator(net);
+    while (pin_iter->hasNext()) {
+      Pin *pin = pin_iter->next();
+      bool is_top = network->isTopLevelPort(pin);
+      writer.writeU8(is_top);
+      if (!is_top)
+	writer.writeString(network->name(network->instance(pin)));
+      writer.writeString(network->portName(pin));
+    }
+    delete pin_iter;
+  }
+  delete net_iter;
+}
+
+void
+readSnapshot(const char *filename,
+	     LefDefNetwork *network)
+{
+  Report *report = network->report();
+  Library *lef_library = network->lefLibrary();
+  if (lef_library == nullptr) {
+    report->printError("Error; no LEF library has been read.\n");
+    return;
+  }
+  SnapshotReader reader(filename);
+  if (reader.readU32() != snapshot_magic) {
+    report->printError("Error: %s is not a snapshot file.\n", filename);
+    return;
+  }
+  if (reader.readU32() != snapshot_version) {
+    report->printError("Error: %s snapshot version mismatch.\n", filename);
+    return;
+  }
+
+  // A snapshot is not DEF, so clear the input DEF filename. write_def
+  // after a restore emits the design from scratch instead of rewriting
+  // the input file.
+  network->setDefFilename(nullptr);
+  char divider = reader.readU8();
+  char bus_brkt_left = reader.readU8();
+  char bus_brkt_right = reader.readU8();
+  network->setDivider(divider);
+  ConcreteLibrary *lef_clib = reinterpret_cast<ConcreteLibrary*>(lef_library);
+  lef_clib->setBusBrkts(bus_brkt_left, bus_brkt_right);
+  network->setDefUnits(reader.readS32());
+  DefDbu die_lx = reader.readS32();
+  DefDbu die_ly = reader.readS32();
+  DefDbu die_ux = reader.readS32();
+  DefDbu die_uy = reader.readS32();
+  network->setDieArea(die_lx, die_ly, die_ux, die_uy);
+
+  Cell *top_cell = network->makeCell(lef_library, reader.readString(),
+				     false, filename);
+  Instance *top_instance = network->makeInstance(top_cell, "", nullptr);
+  network->setTopInstance(top_instance);
+
+  uint32_t port_count = reader.readU32();
+  for (uint32_t i = 0; i < port_count && !reader.corrupt(); i++) {
+    Port *port = network->makePort(top_cell, reader.readString());
+    network->setDirection(port, charDirection(reader.readU8()));
+    bool placed = reader.readU8();
+    DefDbu x = reader.readS32();
+    DefDbu y = reader.readS32();
+    if (placed)
+      network->setLocation(port, DefPt(x, y));
+  }
+  network->initTopInstancePins();
+  network->groupBusPorts(top_cell);
+
+  uint32_t component_count = reader.readU32();
+  for (uint32_t i = 0; i < component_count && !reader.corrupt(); i++) {
+    const char *inst_name = reader.readString();
+    string inst_name_str = inst_name;
+    const char *cell_name = reader.readString();
+    DefDbu x = reader.readS32();
+    DefDbu y = reader.readS32();
+    int orient = reader.readS32();
+    int status = reader.readS32();
+    Cell *cell = network->findCell(lef_library, cell_name);
+    if (cell) {
+      Instance *inst = network->makeDefComponent(cell, inst_name_str.c_str(),
+						 nullptr, false);
+      if (status)
+	network->setLocation(inst, x, y, orient, status);
+    }
+    else
+      report->printError("Error: component %s macro %s not found.\n",
+			 inst_name_str.c_str(),
+			 cell_name);
+  }
+
+  uint32_t net_count = reader.readU32();
+  for (uint32_t i = 0; i < net_count && !reader.corrupt(); i++) {
+    Net *net = network->makeNet(reader.readString(), top_instance);
+    uint32_t conn_count = reader.readU32();
+    for (uint32_t j = 0; j < conn_count && !reader.corrupt(); j++) {
+      bool is_top = reader.readU8();
+      if (is_top) {
+	const char *port_name = reader.readString();
+	Pin *pin = network->findPin(top_instance, port_name);
+	if (pin == nullptr) {
+	  Port *port = network->findPort(top_cell, port_name);
+	  if (port)
+	    pin = network->makePin(top_instance, port, nullptr);
+	  else
+	    report->printError("Error: net %s connection to PIN %s not found.\n",
+			       network->name(net),
+			       port_name);
+	}
+	if (pin)
+	  network->makeTerm(pin, net);
+      }
+      else {
+	string inst_name = reader.readString();
+	const char *port_name = reader.readString();
+	Instance *inst = network->findChild(top_instance, inst_name.c_str());
+	if (inst) {
+	  Port *port = network->findPort(network->cell(inst), port_name);
+	  if (port)
+	    network->connect(inst, port, net);
+	  else
+	    report->printError("Error: net %s connection to component %s pin %s not found.\n",
+			       network->name(net),
+			       inst_name.c_str(),
+			       port_name);
+	}
+	else
+	  report->printError("Error: net %s connection component %s not found.\n",
+			     network->name(net),
+			     inst_name.c_str());
+      }
+    }
+  }
+  if (reader.corrupt())
+    report->printError("Error: snapshot file %s is truncated or corrupt.\n",
+		       filename);
+}
+
+////////////////////////////////////////////////////////////////
+
+static char
+directionChar(PortDirection *dir)
+{
+  if (dir == PortDirection::input())
+    return 'i';
+  else if (dir == PortDirection::output())
+    return 'o';
+  else if (dir == PortDirection::tristate())
+    return 't';
+  else if (dir == PortDirection::bidirect())
+    return 'b';
+  else if (dir == PortDirection::power())
+    return 'p';
+  else if (dir == PortDirection::ground())
+    return 'g';
+  else
+    return 'u';
+}
+
+static PortDirection *
+charDirection(char dir_char)
+{
+  switch (dir_char) {
+  case 'i':
+    return PortDirection::input();
+  case 'o':
+    return PortDirection::output();
+  case 't':
+    return PortDirection::tristate();
+  case 'b':
+    return PortDirection::bidirect();
+  case 'p':
+    return PortDirection::power();
+  case 'g':
+    return PortDirection::ground();
+  default:
+    return PortDirection::unknown();
+  }
+}
+
+} // namespace
@@ -0,0 +1,36 @@
+// Resizer, LEF/DEF gate resizer
+// Copyright (c) 2019, Parallax Software, Inc.
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+#ifndef RESIZER_SNAPSHOT_H
+#define RESIZER_SNAPSHOT_H
+
+namespace sta {
+
+class LefDefNetwork;
+
+// Versioned binary image of the DEF derived network (top ports,
+// components, nets, placement) that loads with sequential reads,
+// replacing the DEF parse on session restart. The LEF library must
+// be read before the snapshot, as before read_def.
+void
+writeSnapshot(const char *filename,
+	      LefDefNetwork *network);
+void
+readSnapshot(const char *filename,
+	     LefDefNetwork *network);
+
+} // namespace
+#endif
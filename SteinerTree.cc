@@ -14,8 +14,11 @@
 // You should have received a copy of the GNU General Public License
 // along with this program.  If not, see <https://www.gnu.org/licenses/>.
 
+#include <atomic>
 #include <fstream>
+#include <mutex>
 #include <string>
+#include <thread>
 #include <unistd.h>
 #include "Machine.hh"
 #include "Report.hh"
@@ -37,6 +40,13 @@ connectedPins(const Net *net,
 	      // Return value.
 	      PinSeq &pins);
 
+// Directory holding the Flute LUT files, recorded by readFluteInits().
+static string flute_lut_dir;
+static std::once_flag flute_lut_once;
+
+// Locate the LUT files but defer the multi-megabyte text parse in
+// Flute::readLUT() until the first Steiner tree is built, so process
+// startup does not pay for tables a run may never use.
 bool
 readFluteInits(string dir)
 {
@@ -47,17 +57,29 @@ readFluteInits(string dir)
   stringPrint(flute_path1, "%s/%s", etc.c_str(), FLUTE_POWVFILE);
   stringPrint(flute_path2, "%s/%s", etc.c_str(), FLUTE_POSTFILE);
   if (fileExists(flute_path1) && fileExists(flute_path2)) {
-    char *cwd = getcwd(NULL, 0);
-    chdir(etc.c_str());
-    Flute::readLUT();
-    chdir(cwd);
-    free(cwd);
+    flute_lut_dir = etc;
     return true;
   }
   else
     return false;
 }
 
+// readLUT() fully populates the POWV/POST tables, and nothing in
+// Flute writes them afterwards, so once this returns the LUTs are
+// immutable shared state and flute() calls may run concurrently.
+static void
+ensureFluteInited()
+{
+  std::call_once(flute_lut_once, []() {
+    // Flute reads the LUT files from the current directory.
+    char *cwd = getcwd(NULL, 0);
+    chdir(flute_lut_dir.c_str());
+    Flute::readLUT();
+    chdir(cwd);
+    free(cwd);
+  });
+}
+
 // c++17 std::filesystem::exists
 static bool
 fileExists(const string &filename)
@@ -70,10 +92,36 @@ fileExists(const string &filename)
 
 SteinerPt SteinerTree::null_pt = -1;
 
+FluteDbu *
+SteinerScratch::x(int pin_count)
+{
+  if (static_cast<int>(x_.size()) < pin_count)
+    x_.resize(pin_count);
+  return &x_[0];
+}
+
+FluteDbu *
+SteinerScratch::y(int pin_count)
+{
+  if (static_cast<int>(y_.size()) < pin_count)
+    y_.resize(pin_count);
+  return &y_[0];
+}
+
 SteinerTree *
 makeSteinerTree(const Net *net,
 		bool find_left_rights,
 		LefDefNetwork *network)
+{
+  SteinerScratch scratch;
+  return makeSteinerTree(net, find_left_rights, network, scratch);
+}
+
+SteinerTree *
+makeSteinerTree(const Net *net,
+		bool find_left_rights,
+		LefDefNetwork *network,
+		SteinerScratch &scratch)
 {
   Network *sdc_network = network->sdcNetwork();
   Debug *debug = network->debug();
@@ -86,11 +134,20 @@ makeSteinerTree(const Net *net,
   connectedPins(net, network, pins);
   // Steiner tree is apparently sensitive to pin order.
   // Pay the price to stabilize the results.
-  sort(pins, PinPathNameLess(network));
+  // Compare instance/port names directly rather than pathName(),
+  // whose temporary string buffers are not safe on worker threads.
+  sort(pins, [network](const Pin *pin1, const Pin *pin2) {
+    int cmp = strcmp(network->name(network->instance(pin1)),
+		     network->name(network->instance(pin2)));
+    return cmp < 0
+      || (cmp == 0
+	  && stringLess(network->portName(pin1),
+			network->portName(pin2)));
+  });
   int pin_count = pins.size();
   if (pin_count >= 2) {
-    FluteDbu *x = new FluteDbu[pin_count];
-    FluteDbu *y = new FluteDbu[pin_count];
+    FluteDbu *x = scratch.x(pin_count);
+    FluteDbu *y = scratch.y(pin_count);
     for (int i = 0; i < pin_count; i++) {
       Pin *pin = pins[i];
       DefPt loc = network->location(pin);
@@ -102,6 +159,7 @@ makeSteinerTree(const Net *net,
     }
 
     int flute_accuracy = 3;
+    ensureFluteInited();
     Flute::Tree ftree = Flute::flute(pin_count, x, y, flute_accuracy);
     tree->setTree(ftree, network);
     if (debug->check("steiner", 3)) {
@@ -114,14 +172,49 @@ makeSteinerTree(const Net *net,
       tree->findLeftRights(network);
     if (debug->check("steiner", 2))
       tree->report(network);
-    delete [] x;
-    delete [] y;
     return tree;
   }
   else
     return nullptr;
 }
 
+void
+makeSteinerTrees(const NetSeq &nets,
+		 bool find_left_rights,
+		 int thread_count,
+		 LefDefNetwork *network,
+		 // Return value.
+		 SteinerTreeSeq &trees)
+{
+  trees.resize(nets.size());
+  if (thread_count <= 1) {
+    SteinerScratch scratch;
+    for (size_t i = 0; i < nets.size(); i++)
+      trees[i] = makeSteinerTree(nets[i], find_left_rights, network,
+				 scratch);
+  }
+  else {
+    // Load the LUTs before the workers race to it.
+    ensureFluteInited();
+    std::atomic<size_t> next_index(0);
+    std::vector<std::thread> workers;
+    for (int i = 0; i < thread_count; i++) {
+      workers.push_back(std::thread([&]() {
+	SteinerScratch scratch;
+	while (true) {
+	  size_t j = next_index.fetch_add(1);
+	  if (j >= nets.size())
+	    break;
+	  trees[j] = makeSteinerTree(nets[j], find_left_rights, network,
+				     scratch);
+	}
+      }));
+    }
+    for (auto &worker : workers)
+      worker.join();
+  }
+}
+
 static void
 connectedPins(const Net *net,
 	      Network *network,
@@ -418,4 +511,51 @@ SteinerTree::right(SteinerPt pt)
   return right_[pt];
 }
 
+////////////////////////////////////////////////////////////////
+
+SteinerTreeCache::SteinerTreeCache()
+{
+}
+
+SteinerTreeCache::~SteinerTreeCache()
+{
+  clear();
+}
+
+SteinerTree *
+SteinerTreeCache::find(const Net *net)
+{
+  std::lock_guard<std::mutex> guard(lock_);
+  return tree_map_.findKey(net);
+}
+
+void
+SteinerTreeCache::insert(const Net *net,
+			 SteinerTree *tree)
+{
+  std::lock_guard<std::mutex> guard(lock_);
+  SteinerTree *prev = tree_map_.findKey(net);
+  if (prev && prev != tree)
+    delete prev;
+  tree_map_[net] = tree;
+}
+
+void
+SteinerTreeCache::erase(const Net *net)
+{
+  std::lock_guard<std::mutex> guard(lock_);
+  SteinerTree *tree = tree_map_.findKey(net);
+  if (tree) {
+    delete tree;
+    tree_map_.erase(net);
+  }
+}
+
+void
+SteinerTreeCache::clear()
+{
+  std::lock_guard<std::mutex> guard(lock_);
+  tree_map_.deleteContentsClear();
+}
+
 }
@@ -17,6 +17,7 @@
 #ifndef RESIZER_STEINER_TREE_H
 #define RESIZER_STEINER_TREE_H
 
+#include <mutex>
 #include <string>
 #include "Hash.hh"
 #include "LefDefNetwork.hh"
@@ -35,6 +36,21 @@ class LefDefNetwork;
 typedef int SteinerPt;
 typedef Vector<SteinerPt> SteinerPtSeq;
 
+typedef Vector<SteinerTree*> SteinerTreeSeq;
+
+// Reusable pin coordinate buffers so makeSteinerTree does not
+// allocate per call. Each thread needs its own.
+class SteinerScratch
+{
+public:
+  FluteDbu *x(int pin_count);
+  FluteDbu *y(int pin_count);
+
+protected:
+  Vector<FluteDbu> x_;
+  Vector<FluteDbu> y_;
+};
+
 bool
 readFluteInits(string dir);
 // Returns nullptr if net has less than 2 pins.
@@ -42,6 +58,22 @@ SteinerTree *
 makeSteinerTree(const Net *net,
 		bool find_left_rights,
 		LefDefNetwork *network);
+// Reentrant form safe on worker threads once the Flute LUTs are
+// loaded; scratch is caller owned, one per thread.
+SteinerTree *
+makeSteinerTree(const Net *net,
+		bool find_left_rights,
+		LefDefNetwork *network,
+		SteinerScratch &scratch);
+// Build trees for nets on a pool of thread_count workers.
+// trees[i] is the tree for nets[i] (nullptr for degenerate nets).
+void
+makeSteinerTrees(const NetSeq &nets,
+		 bool find_left_rights,
+		 int thread_count,
+		 LefDefNetwork *network,
+		 // Return value.
+		 SteinerTreeSeq &trees);
 
 class DefPtHash
 {
@@ -103,6 +135,7 @@ public:
   SteinerPt left(SteinerPt pt);
   SteinerPt right(SteinerPt pt);
   void findLeftRights(const Network *network);
+  bool hasLeftRights() const { return !left_.empty(); }
   static SteinerPt null_pt;
 
 protected:
@@ -129,5 +162,25 @@ protected:
   SteinerPtSeq right_;
 };
 
+// Cache of Steiner trees for unmodified nets so repeated
+// makeNetParasitics/rebuffer passes do not rebuild the same Flute
+// tree. Entries are erased when a pin connection or location on the
+// net changes. Locked internally so parallel passes can share it.
+class SteinerTreeCache
+{
+public:
+  SteinerTreeCache();
+  ~SteinerTreeCache();
+  SteinerTree *find(const Net *net);
+  void insert(const Net *net,
+	      SteinerTree *tree);
+  void erase(const Net *net);
+  void clear();
+
+protected:
+  UnorderedMap<const Net*, SteinerTree*> tree_map_;
+  std::mutex lock_;
+};
+
 } // namespace
 #endif
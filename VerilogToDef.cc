@@ -239,7 +239,7 @@ main(int argc,
       writeDef(def_filename, units,
 	       die_lx, die_ly, die_ux, die_uy,
 	       core_lx, core_ly, core_ux, core_uy,
-	       site_name, tracks_file, auto_place_pins, true,
+	       site_name, tracks_file, auto_place_pins, true, 1,
 	       &network);
       if (verbose)
 	report->print("\n");
@@ -0,0 +1,28 @@
+# Synthetic design benchmark for the resizer kernels.
+# Run via the resizer_bench build target, or directly with
+#   resizer -no_init -no_splash -exit bench.tcl
+# Set the bench_* variables before sourcing to override the defaults.
+if { ![info exists bench_instances] } { set bench_instances 50000 }
+if { ![info exists bench_max_fanout] } { set bench_max_fanout 8 }
+if { ![info exists bench_spread] } { set bench_spread 4.0 }
+if { ![info exists bench_seed] } { set bench_seed 1 }
+if { ![info exists bench_threads] } { set bench_threads 1 }
+
+read_liberty liberty1.lib
+read_lef liberty1.lef
+make_bench_design -cell liberty1/snl_bufx2 \
+  -instances $bench_instances \
+  -max_fanout $bench_max_fanout \
+  -spread $bench_spread \
+  -seed $bench_seed
+
+create_clock -name clk -period 1
+set_input_delay -clock clk 0 [all_inputs]
+set_output_delay -clock clk 0 [all_outputs]
+
+clear_resizer_stats
+# kohm/micron, pf/micron
+# use 100x wire cap to tickle buffer insertion
+set_wire_rc -resistance 1.7e-4 -capacitance 1.3e-2 -threads $bench_threads
+resize -buffer_cell liberty1/snl_bufx2
+report_resizer_stats
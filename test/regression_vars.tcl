@@ -138,6 +138,7 @@ record_resizer_tests {
   resize4
   resize5
   resize6
+  snapshot1
   write_def1
   write_def2
   write_def3
@@ -145,6 +146,7 @@ record_resizer_tests {
   write_def5
   write_def6
   write_def7
+  write_def8
   verilog2def1
   verilog2def2
   verilog2def3
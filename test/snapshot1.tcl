@@ -0,0 +1,25 @@
+# write_snapshot/read_snapshot round trip
+source helpers.tcl
+read_liberty liberty1.lib
+read_lef liberty1.lef
+read_def reg1.def
+
+# DEF written from the DEF-parsed network.
+set def_file1 [make_result_file snapshot1_def.def]
+write_def $def_file1
+report_file $def_file1
+
+set snapshot_file [make_result_file snapshot1.snapshot]
+write_snapshot $snapshot_file
+read_snapshot $snapshot_file
+
+# DEF written from the snapshot-restored network, for comparison to
+# the one written from the DEF-parsed network above.
+set_design_size \
+  -die {0 0 1000 1000} \
+  -core {100 100 900 900}
+set def_file2 [make_result_file snapshot1_snapshot.def]
+write_def -units 100 \
+  -sort \
+  $def_file2
+report_file $def_file2
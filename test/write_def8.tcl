@@ -0,0 +1,28 @@
+# incremental write_def after edits
+source helpers.tcl
+read_liberty liberty1.lib
+read_lef liberty1.lef
+read_def reg1.def
+
+# Resize u1; r2, r3, u2 and their nets are untouched.
+replace_cell u1 snl_bufx2
+
+# Insert buffer b1 between u2 and r3.
+disconnect_pin u2z r3/D
+make_net b1z
+make_instance b1 snl_bufx1
+connect_pin u2z b1/A
+connect_pin b1z b1/Z
+connect_pin b1z r3/D
+
+# Delete r1 and its output net.
+disconnect_pin in1 r1/D
+disconnect_pin clk1 r1/CP
+disconnect_pin r1q r1/Q
+disconnect_pin r1q u2/A
+delete_instance r1
+delete_net r1q
+
+set def_file [make_result_file write_def8.def]
+write_def $def_file
+report_file $def_file